@@ -10,7 +10,7 @@
 *
 * Library for ADXL345 Accelerometer
 *
-* Functions: accel_init(), convert_accelerometer(), read_accelerometer(), calibrate_accel()
+* Functions: accel_init(), convert_accelerometer(), accel_pitch(), read_accelerometer(), calibrate_accel()
 * Global Variables: None
 */
 
@@ -69,6 +69,18 @@ float convert_accelerometer(UINT16 value)
 	return (g_value*0.00390625);
 }
 
+/**********************************
+Function name	:	accel_pitch
+Functionality	:	Computes the pitch angle from the X and Z axis accelerations
+Arguments		:	X and Z axis accelerations (g)
+Return Value	:	Pitch angle in degrees
+Example Call	:	accel_pitch(x_accel, z_accel)
+***********************************/
+float accel_pitch(float x_accel, float z_accel)
+{
+	return (atan2(-x_accel, z_accel)*180.0)/3.1416;
+}
+
 /**********************************
 Function name	:	read_accelerometer
 Functionality	:	Reads the acceleration along X,Y,Z axes
@@ -91,7 +103,7 @@ float read_accelerometer()
 	z_accel = convert_accelerometer((UINT8)accel_raw_Z[0] | (UINT8)accel_raw_Z[1]<<8);
 	
 	// Compute the pitch angle and convert to degrees
-	pitch_angle = (atan2(-x_accel, z_accel)*180.0)/3.1416;
+	pitch_angle = accel_pitch(x_accel, z_accel);
 	
 	return pitch_angle;
 }
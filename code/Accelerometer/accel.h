@@ -57,6 +57,15 @@ Example Call	:	convert_accelerometer(Z_DATA)
 ***********************************/
 float convert_accelerometer(UINT16 value);
 
+/**********************************
+Function name	:	accel_pitch
+Functionality	:	Computes the pitch angle from the X and Z axis accelerations
+Arguments		:	X and Z axis accelerations (g)
+Return Value	:	Pitch angle in degrees
+Example Call	:	accel_pitch(x_accel, z_accel)
+***********************************/
+float accel_pitch(float x_accel, float z_accel);
+
 /**********************************
 Function name	:	read_accelerometer
 Functionality	:	Reads the acceleration along X,Y,Z axes
@@ -51,14 +51,23 @@
 */
 
 // Libraries
-#include <Arduino.h>
+#include "Support/platform.h"
 #include "Timers/timers.h"
 #include "I2C/i2c_lib.h"
 #include "Accelerometer/accel.h"
 #include "Gyroscope/gyro.h"
+#include "Magnetometer/mag.h"
 #include "Motors/motors.h"
 #include "Controller/controller.h"
 #include "Indicators/indicators.h"
+#include "Profile/profile.h"
+#include "Battery/battery.h"
+#include "SysId/sysid.h"
+#include "Odometry/odometry.h"
+#include "State/state.h"
+#include "Stack/stack.h"
+#include "PID/pid.h"
+#include "pid_gains.h"
 #include "Balance_Bot_2403.h"
 
 /**********************************
@@ -71,7 +80,20 @@ Example Call	:	Called automatically
 ISR(TIMER3_OVF_vect)
 {
 	TIMSK3 = 0x00;	
+	STACK_ISR_BEGIN();
+	if (mag_busy()) mag_abort();	// Free the bus for the blocking sensor reads
 	read_tilt_angle();	
+	read_yaw_angle();
+	
+	// Publish the attitude for the control loop
+	shared_state.tilt_angle = tilt_angle;
+	shared_state.gyro_angle = gyro_angle;
+	shared_state.accel_angle = accel_angle;
+	shared_state.yaw_angle = yaw_angle;
+	shared_state.yaw_rate = read_yaw_rate();
+	state_publish();
+	STACK_ISR_END(STACK_ISR_TILT);
+	
 	TCNT3 = 0xFF70;
 	TIMSK3 = 0x01;
 }
@@ -86,32 +108,23 @@ Example Call	:	Called automatically
 ISR(TIMER1_OVF_vect)
 {
 	TCNT1 = 0xFB80;
+	STACK_ISR_BEGIN();
 	
 	// Make a local copy of the global encoder count
-	volatile float left_current_count = left_encoder_count;
-	volatile float right_current_count = right_encoder_count;
+	float left_current_count = left_encoder_count;
+	float right_current_count = right_encoder_count;
+	unsigned long now = epoch_ticks();
 	
-	//		 (Change in encoder count) * (60 sec/1 min)
-	// RPM = __________________________________________
-	//		 (Change in time --> 20ms) * (PPR --> 840)
-	left_RPM = (float)(((left_current_count - left_prev_count) * 60)/(0.02*420));
-	right_RPM = (float)(((right_current_count - right_prev_count) * 60)/(0.02*420));
+	// Blend edge timing and count difference for each wheel
+	shared_state.left_RPM = encoder_RPM(&left_timing, left_current_count - left_prev_count, now);
+	shared_state.right_RPM = encoder_RPM(&right_timing, right_current_count - right_prev_count, now);
+	shared_state.encoder_count = left_current_count + right_current_count;
+	state_publish();
 	
 	// Store current encoder count for next iteration
 	left_prev_count = left_current_count;
 	right_prev_count = right_current_count;
-}
-
-/**********************************
-Function name	:	encoder_count
-Functionality	:	Returns the current encoder count
-Arguments		:	None
-Return Value	:	Encoder count sum
-Example Call	:	encoder_count()
-***********************************/
-float encoder_count()
-{
-	return (left_encoder_count + right_encoder_count);
+	STACK_ISR_END(STACK_ISR_RPM);
 }
 
 /**********************************
@@ -136,18 +149,74 @@ Example Call	:	read_tilt_angle()
 void read_tilt_angle()
 {
 	// Compute pitch angle from Gyroscope
-	gyro_angle = get_gyro_angle(epoch(), angle.position);
+	gyro_angle = get_gyro_angle(epoch(), tilt_angle);
 	
 	// Compute pitch angle from Accelerometer
 	accel_angle = read_accelerometer();
 	
 	// Fuse the pitch angles using a Complimentary Filter
-	angle.position = complimentary_filter(gyro_angle, accel_angle, COMP_FILTER_ALPHA);
+	tilt_angle = complimentary_filter(gyro_angle, accel_angle, COMP_FILTER_ALPHA);
+}
+
+/**********************************
+Function name	:	wrap_angle
+Functionality	:	To wrap an angle to the -180 to 180 degree range
+Arguments		:	Angle in degrees
+Return Value	:	Wrapped angle
+Example Call	:	wrap_angle(yaw_angle + 5)
+***********************************/
+float wrap_angle(float value)
+{
+	if (value > 180) return (value - 360);
+	if (value < -180) return (value + 360);
+	return value;
+}
+
+/**********************************
+Function name	:	read_yaw_angle
+Functionality	:	Compute the heading by integrating the gyroscope yaw rate and correcting
+					the drift with the magnetometer heading, starts the next magnetometer read
+Arguments		:	None
+Return Value	:	None
+Example Call	:	read_yaw_angle()
+***********************************/
+void read_yaw_angle()
+{
+	float mag_heading = 0;
+	
+	// Integrate the yaw rate read with the pitch rate (100Hz)
+	yaw_angle = wrap_angle(yaw_angle + read_yaw_rate()*0.01);
+	
+	// Fuse the magnetometer heading, the first sample sets the initial heading
+	if (read_mag_heading(tilt_angle, &mag_heading))
+	{
+		if (!YAW_INIT) yaw_angle = mag_heading;
+		else yaw_angle = wrap_angle(yaw_angle + (1 - YAW_FILTER_ALPHA)*wrap_angle(mag_heading - yaw_angle));
+		YAW_INIT = true;
+	}
+	
+	// Read the magnetometer at 50Hz in the background, it is done well before the next tick
+	MAG_TICK = !MAG_TICK;
+	if (MAG_TICK) mag_start_read();
+}
+
+/**********************************
+Function name	:	rate_limit
+Functionality	:	To move a value towards a target by at most a fixed step
+Arguments		:	Current value, Target value, Maximum step
+Return Value	:	Rate limited value
+Example Call	:	rate_limit(turn_command, 1.0, TURN_RATE_LIMIT)
+***********************************/
+float rate_limit(float value, float target, float max_step)
+{
+	if ((target - value) > max_step) return (value + max_step);
+	if ((value - target) > max_step) return (value - max_step);
+	return target;
 }
 
 /**********************************
 Function name	:	handle_buttons
-Functionality	:	To handle the button inputs of the Joystick Controller 
+Functionality	:	To handle the Y-Axis and button inputs of the Joystick Controller 
 					and update the status/motion of the robot accordingly
 Arguments		:	None
 Return Value	:	None
@@ -155,36 +224,32 @@ Example Call	:	handle_buttons()
 ***********************************/
 void handle_buttons()
 {
-	// Button 4 - Move Forward
-	if ((joystick.button_4 == HIGH) && ((epoch() - joystick.b4_time) >= 1))
-	{
-		joystick.b4_time = epoch();
-		
-		// Update set-point
-		encoder.set_point += 0.1*FULL_SPEED; // Increment the Position Set Point at a Defined Speed
-		velocity.set_point = FORWARD_SPEED;
-		move_offset = -0.05;
-		
-		// Update flags
-		set_led_indicators(false, true, false, false, false, false);
-		
-		// Set STOP_FLAG to False to avoid Static Balance/Position Holding
-		STOP_FLAG = false;
-		SLOPE_FLAG = false;
-	}
+	float drive_target = joystick.y_command;
+	float position_step = 0;
+	
+	// Button 4/1 - Full speed Forward/Back, overrides the joystick
+	if (joystick.button_4 == HIGH) drive_target = 1;
+	else if (joystick.button_1 == HIGH) drive_target = -1;
+	
+	// Convert the command to a target velocity in RPM
+	if (drive_target > 0) drive_target *= FORWARD_SPEED;
+	else drive_target *= REVERSE_SPEED;
+	
+	// Advance the S-curve profile towards the target velocity by one control period
+	position_step = profile_update(&drive_profile, drive_target, 0.02);
 	
-	// Button 1 - Move Back
-	else if ((joystick.button_1 == HIGH) && ((epoch() - joystick.b1_time) >= 1))
+	// Joystick Y-Axis/Button 4/Button 1 - Move Forward/Back along the profile
+	if ((drive_target != 0) || (drive_profile.velocity != 0))
 	{
-		joystick.b1_time = epoch();
-		
-		// Update set-point
-		encoder.set_point -= 0.1*FULL_SPEED; // Increment the Position Set Point at a Defined Speed
-		velocity.set_point = -REVERSE_SPEED;
-		move_offset = 0.05;
+		// Update set-points with consistent position, velocity and acceleration
+		encoder.set_point += position_step*2*ENCODER_CPR;	// Sum of both encoders
+		velocity.set_point = drive_profile.velocity;
+		move_offset = -0.05*drive_profile.velocity/FORWARD_SPEED;
+		accel_offset = -ACCEL_FEEDFORWARD*drive_profile.acceleration;
 		
 		// Update flags
-		set_led_indicators(false, false, true, false, false, false);
+		if (drive_profile.velocity >= 0) set_led_indicators(false, true, false, false, false, false);
+		else set_led_indicators(false, false, true, false, false, false);
 		
 		// Set STOP_FLAG to False to avoid Static Balance/Position Holding
 		STOP_FLAG = false;
@@ -212,13 +277,14 @@ void handle_buttons()
 	// Button 0 - Hold Position
 	else if (!STOP_FLAG)
 	{
-		// Reset count to current position
-		left_encoder_count = right_encoder_count = 0;
-		encoder.set_point = encoder_count();
+		// Hold the current position
+		encoder.set_point = robot.encoder_count;
 		
 		velocity.set_point = 0;
 		slope_offset = 0;
 		move_offset = 0;
+		accel_offset = 0;
+		profile_reset(&drive_profile);
 		
 		// Update flags
 		set_led_indicators(true, false, false, false, false, false);
@@ -241,43 +307,26 @@ void handle_buttons()
 /**********************************
 Function name	:	steer_robot
 Functionality	:	To set the direction, speed and the status of the robot
+					from the proportional joystick commands
 Arguments		:	None
 Return Value	:	None
 Example Call	:	steer_robot()
 ***********************************/
 void steer_robot()
 {
-	// Update the rotation variables
-	switch(joystick.x_position)
-	{
-		// Zone -2/-1 --> Rotate Right
-		case -2:
-		case -1:
-			// Set the turning speed
-			rotation_left = TURN_SPEED;
-			rotation_right = -TURN_SPEED;			
-			set_led_indicators(false, false, false, false, true, false);
-			ROTATION_FLAG = true;
-		break;
-		
-		// Neutral Position
-		case 0:
-			rotation_left = 0;
-			rotation_right = 0;			
-			set_led_indicators(true, false, false, false, false, false);
-			ROTATION_FLAG = false;
-		break;
-		
-		// Zone 1/2 --> Rotate Left
-		case 1:
-		case 2:
-			// Set the turning speed
-			rotation_left = -TURN_SPEED;
-			rotation_right = TURN_SPEED;			
-			set_led_indicators(false, false, false, true, false, false);
-			ROTATION_FLAG = true;
-		break;
-	}
+	// Ramp the turn command towards the joystick X-Axis position
+	turn_command = rate_limit(turn_command, joystick.x_command, TURN_RATE_LIMIT);
+	
+	// Set the turning speed proportional to the command
+	// Negative --> Rotate Right, Positive --> Rotate Left
+	rotation_left = -turn_command*TURN_SPEED;
+	rotation_right = turn_command*TURN_SPEED;
+	
+	// Update the rotation flags
+	if (turn_command < 0) set_led_indicators(false, false, false, false, true, false);
+	else if (turn_command > 0) set_led_indicators(false, false, false, true, false, false);
+	else set_led_indicators(true, false, false, false, false, false);
+	ROTATION_FLAG = (turn_command != 0);
 	
 	// Handle the Controller's Push Button Inputs
 	handle_buttons();
@@ -285,24 +334,32 @@ void steer_robot()
 
 /**********************************
 Function name	:	compute_rotation_PID
-Functionality	:	To prevent the rotational drift of the robot during static balance using a 
-					simple Proportional controller to minimize difference in encoder counts
+Functionality	:	To hold the heading of the robot when it is not being turned using a
+					PD controller on the fused yaw angle, independent of wheel slip
 Arguments		:	None
 Return Value	:	None
 Example Call	:	compute_rotation_PID()
 ***********************************/
 void compute_rotation_PID()
 {
-	// Avoid rotational correction when joystick controller is being used to turn the robot
-	if (ROTATION_FLAG)
+	heading.position = robot.yaw_angle;
+	
+	// Hold the heading reached at the end of a turn, and the start-up heading
+	if (ROTATION_FLAG || !read_ready_state())
 	{
-		left_encoder_count = right_encoder_count;	// Equalize the offset	
+		heading.set_point = heading.position;
 		return;
 	}
 	
-	// Correct rotation drift by computing the difference between the encoder positions
-	rotation_left = -1 * LEFT_GAIN * (left_encoder_count - right_encoder_count) * 0.05;
-	rotation_right = RIGHT_GAIN * (left_encoder_count - right_encoder_count) * 0.05;
+	// Shortest way back to the set point, yaw rate as the derivative
+	heading.error = wrap_angle(heading.set_point - heading.position);
+	heading.derivative = robot.yaw_rate;
+	heading.output = heading.con_KP*heading.error - heading.con_KD*heading.derivative;
+	heading.output = constrain(heading.output, -HEADING_MAX, HEADING_MAX);
+	
+	// Positive --> Rotate Left
+	rotation_left = -heading.output;
+	rotation_right = heading.output;
 }
 
 /**********************************
@@ -322,7 +379,7 @@ void compute_velocity_PID()
 	float velocity_KP = 0;
 	
 	// Get current linear velocity measured using encoders
-	velocity.position = (left_RPM + right_RPM)/2.0; // Average of both motor RPMs
+	velocity.position = (robot.left_RPM + robot.right_RPM)/2.0; // Average of both motor RPMs
 	
 	// Compute error
 	velocity.error = velocity.set_point - velocity.position;
@@ -381,7 +438,7 @@ void compute_encoder_PID()
 	float encoder_KP = 0;
 	
 	// Get current encoder position
-	encoder.position = encoder_count();
+	encoder.position = robot.encoder_count;
 	
 	// Compute position error
 	encoder.error = encoder.set_point - encoder.position;
@@ -426,61 +483,14 @@ Example Call	:	compute_angle_PID()
 ***********************************/
 void compute_angle_PID()
 {
-	float angle_KP=0, angle_KI=0, angle_KD=0;
-	float angle_position;
-	
-	// Obtain the current tilt angle and make a copy to avoid
-	// abrupt changes during current PID computation loop
-	angle_position = angle.position;
+	// Tilt angle from the snapshot of this control tick
+	angle.position = robot.tilt_angle;
 	
 	// Add all the offsets to the angle set-point
-	angle.set_point = TILT_ANGLE_OFFSET + move_offset + slope_offset + encoder.output + velocity.output;
-	
-	// Compute tilt angle error
-	angle.error = angle.set_point - angle_position;
-	
-	// Turn motors off if robot falls beyond recoverable angle and await human rescue
-	if (abs(angle.error) >= 75)
-	{
-		angle.output = 0;
-		return;
-	}
-
-	// Conservative PID gains for |errors| < 3 degress
-	if (abs(angle.error) < 3.0)
-	{
-		angle_KP = angle.con_KP;
-		angle_KI = angle.con_KI;
-		angle_KD = angle.con_KD;
-	}
+	angle.set_point = TILT_ANGLE_OFFSET + move_offset + accel_offset + slope_offset + encoder.output + velocity.output;
 	
-	// Aggressive PID gains for |errors| >= 3 degress
-	else
-	{
-		angle_KP = angle.agr_KP;
-		angle_KI = angle.agr_KI;
-		angle_KD = angle.agr_KD;
-	}
-	
-	// Compute derivative term
-	angle.derivative = angle_position - angle.last_position;
-	
-	// Compute integral sum
-	angle.integral += angle_KI*angle.error;
-	
-	// Constrain integral term to prevent wind-up
-	angle.integral = constrain(angle.integral, -255, 255);
-	
-	// Compute angle PID output
-	angle.output = (angle_KP*angle.error) + (angle.integral) - (angle_KD*angle.derivative);
-	
-	// Constrain angle PID output to PWM range
-	angle.output = constrain(angle.output, -255, 255);
-	
-	//if (abs(angle.error) < 0.2) angle.output = 0;		// For smoothing output
-	
-	// Store variable for next iteration
-	angle.last_position = angle_position;
+	// PID with the conservative and aggressive gains (PID/pid.cpp, shared with Tools/gain_map.cpp)
+	pid_angle_update(&angle);
 }
 
 /**********************************
@@ -498,6 +508,70 @@ void compute_PID()
 	compute_rotation_PID();
 }
 
+/**********************************
+Function name	:	send_telemetry
+Functionality	:	To send the robot status to the telemetry XBee address
+Arguments		:	None
+Return Value	:	None
+Example Call	:	send_telemetry()
+***********************************/
+void send_telemetry()
+{
+	unsigned int millivolts = battery_voltage()*1000;
+	unsigned char packet[4] = {TELEMETRY_BATTERY, (unsigned char)(millivolts >> 8), (unsigned char)millivolts, battery_low()};
+	unsigned char pose[11] = {TELEMETRY_ODOMETRY};
+	unsigned char memory[5 + STACK_ISR_COUNT] = {TELEMETRY_STACK};
+	long x = odometry_x(), y = odometry_y();
+	unsigned int pose_heading = odometry.heading >> 16;
+	unsigned int high_water = stack_high_water(), free_RAM = stack_free();
+	
+	xbee_send_data(packet, 4);
+	
+	// Big endian pose
+	for (int i=0; i<4; i++)
+	{
+		pose[1+i] = x >> (24 - 8*i);
+		pose[5+i] = y >> (24 - 8*i);
+	}
+	pose[9] = pose_heading >> 8;
+	pose[10] = pose_heading & 0xFF;
+	
+	xbee_send_data(pose, 11);
+	
+	// Stack high-water mark and the RAM it never reached
+	memory[1] = high_water >> 8;
+	memory[2] = high_water & 0xFF;
+	memory[3] = free_RAM >> 8;
+	memory[4] = free_RAM & 0xFF;
+	#ifdef STACK_PROFILE
+	for (int i=0; i<STACK_ISR_COUNT; i++) memory[5+i] = (stack_isr_depth(i) > 255) ? 255 : stack_isr_depth(i);
+	xbee_send_data(memory, 5 + STACK_ISR_COUNT);
+	#else
+	xbee_send_data(memory, 5);
+	#endif
+	
+	#ifdef MAG_CALIBRATE
+	// Hard iron offsets and soft iron scale (x1000) of the X and Y axes
+	unsigned char calibration[9] = {TELEMETRY_MAG};
+	for (int i=0; i<2; i++)
+	{
+		int offset = mag.offset[i];
+		unsigned int scale = mag.scale[i]*1000;
+		calibration[1+2*i] = (unsigned int)offset >> 8;
+		calibration[2+2*i] = offset & 0xFF;
+		calibration[5+2*i] = scale >> 8;
+		calibration[6+2*i] = scale & 0xFF;
+	}
+	xbee_send_data(calibration, 9);
+	#endif
+	
+	#ifdef GYRO_TEMP_CALIBRATE
+	// Gyroscope temperature and the points of the table recorded so far
+	unsigned char temperature[3] = {TELEMETRY_GYRO_TEMP, (unsigned char)gyro_temp.temperature, gyro_temp.table.valid};
+	xbee_send_data(temperature, 3);
+	#endif
+}
+
 /**********************************
 Function name	:	task_scheduler
 Functionality	:	To schedule various tasks
@@ -507,20 +581,66 @@ Example Call	:	task_scheduler()
 ***********************************/
 void task_scheduler()
 {
+	#ifdef SYSID_MODE
+	float excitation=0, command=0;
+	#endif
+	
 	read_joystick();	// Read the raw data from Joystick Controller
 	led_scheduler();	// Run the LED scheduler for status/beacon indicator
-	buzz_scheduler();	// Run the buzzer scheduler and play non-blocking RTTTL tones
+	buzz_scheduler();	// Run the buzzer scheduler, RTTTL tones play from the timer interrupts
+	
+	// Ready after the start-up tone once the gyroscope offsets are measured
+	if (!read_ready_state() && gyro_calibrated() && startup_tone_done()) set_ready_state(true);
 	
 	// PID task scheduling every 20ms
 	if ((epoch() - last_task_time_PID) >= 20)
 	{
 		last_task_time_PID = epoch();
 		
-		steer_robot();	// Update the set-points for the various PID loop
-		compute_PID();	// Compute PID values
+		state_snapshot(&robot);	// Consistent copy of the sensor state for this tick
+		battery_update();	// Start the next battery voltage conversion
+		odometry_update();	// Integrate the wheel odometry
+		steer_robot();		// Update the set-points for the various PID loop
+		compute_PID();		// Compute PID values
+		
+		#ifdef SYSID_MODE
+		// Inject the excitation and stream the response
+		excitation = sysid_excitation();
+		#if SYSID_TARGET == SYSID_WHEEL_PWM
+		command = excitation;
+		update_motors(command, 0, 0);
+		#else
+		command = angle.output + excitation;
+		update_motors(command, rotation_left, rotation_right);
+		#endif
+		if (!sysid_done()) sysid_log(excitation, command, robot.tilt_angle, robot.left_RPM, robot.right_RPM);
 		
+		#else
 		// Update the motor speed and direction
 		update_motors(angle.output, rotation_left, rotation_right);
+		#endif
+	}
+	
+	// Telemetry and low battery indicator
+	if ((epoch() - last_task_time_telemetry) >= TELEMETRY_PERIOD)
+	{
+		last_task_time_telemetry = epoch();
+		
+		set_battery_state(battery_low());
+		
+		#ifdef MAG_CALIBRATE
+		if (!MAG_CALIBRATED && (epoch() >= MAG_CALIBRATION_TIME))
+		{
+			mag_calibrate();
+			MAG_CALIBRATED = true;
+		}
+		#endif
+		
+		#ifdef GYRO_TEMP_CALIBRATE
+		save_gyro_temp();	// Save the temperature points recorded since the last frame
+		#endif
+		
+		send_telemetry();
 	}
 }
 
@@ -540,11 +660,14 @@ void init_devices()
 	timer1_init();			// Timer 1 for RPM measurement
 	timer3_init();			// Timer 3 for reading GY80 sensor
 	timer4_init();			// Timer 4 for calculating program time in ms
+	timer5_init();			// Timer 5 for 20kHz motor PWM
 	
 	i2c_init();				// Initialize I2C
 	accel_init();			// Initialize ADXL345
 	gyro_init();			// Initialize L3G4200D
+	mag_init();				// Initialize HMC5883L
 	motors_init();			// Initialize motors and encoders
+	battery_init();			// Initialize battery voltage ADC
 	
 	buzzer_pin_config();	// Initialize buzzer
 	led_pin_config();		// Initialize LEDs
@@ -561,11 +684,20 @@ Example Call	:	setup() - Called internally by main()
 ***********************************/
 void setup()
 {
+	stack_paint();			// Paint the free RAM for the stack high-water mark
 	init_devices();			// Initiate all devices
 	start_timer4();			// Timer for epoch()
 	start_timer3();			// Timer for reading GY80 sensor
 	start_timer1();			// Timer for calculating RPM of motors
 	
+	#ifdef MOTOR_BENCHMARK
+	benchmark_motor_PWM();	// Print the cost of a PWM duty update
+	#endif
+	
+	#ifdef MOTOR_CHARACTERISE
+	characterise_motors();	// Sweep the motors for Tools/motor_lut.cpp
+	#endif
+	
 	// Set PID controller directions
 	angle.direction = 1;
 	velocity.direction = -1;
@@ -35,13 +35,25 @@
 #define SLOPE_SPEED 155
 #define TURN_SPEED 60
 
-// Minimum PWM Values for Motors
-#define LEFT_PWM_MIN 45
-#define RIGHT_PWM_MIN 55
-
-// Rotation Proportional Gains
-#define LEFT_GAIN 10
-#define RIGHT_GAIN 5
+// Command rate limits (maximum change per 20ms control loop)
+#define TURN_RATE_LIMIT 0.2			// Full turn command in 100ms
+
+// Drive motion profile
+#define DRIVE_MAX_ACCEL 250			// Acceleration limit (RPM/s)
+#define DRIVE_MAX_JERK 2500			// Jerk limit (RPM/s^2)
+#define ACCEL_FEEDFORWARD 0.008		// Tilt set-point per unit acceleration (deg per RPM/s)
+
+// Telemetry
+#define TELEMETRY_PERIOD 500		// Telemetry frame interval (ms)
+#define TELEMETRY_BATTERY 0x01		// Packet ID: voltage (mV, 2 bytes), low battery flag
+#define TELEMETRY_ODOMETRY 0x03		// Packet ID: x, y (mm, 4 bytes each), heading (65536 = 360 deg, 2 bytes)
+#define TELEMETRY_MAG 0x04			// Packet ID: X, Y hard iron offsets, X, Y soft iron scale x1000 (2 bytes each)
+#define TELEMETRY_STACK 0x05		// Packet ID: stack high-water mark, free RAM (bytes, 2 bytes each), ISR stack use with STACK_PROFILE (1 byte each)
+#define TELEMETRY_GYRO_TEMP 0x06	// Packet ID: gyroscope temperature (deg C, no fixed offset), bit mask of the recorded table points
+
+// Heading Estimation and Hold
+#define YAW_FILTER_ALPHA 0.99		// Gyroscope weight per magnetometer sample (50Hz)
+#define HEADING_MAX 60				// Largest heading correction (PWM)
 
 // External Variables
 extern JoystickController joystick;
@@ -50,55 +62,35 @@ extern volatile float right_encoder_count;
 
 // Global Variables
 float slope_offset=0, move_offset=0, max_angle_vel=4, max_angle_enc=2;
-volatile float accel_angle=0, gyro_angle=0;
-volatile float rotation_left=0, rotation_right=0;
-volatile float left_RPM=0, right_RPM=0, left_prev_count=0, right_prev_count=0;
-unsigned long last_task_time_PID=0;
+float accel_offset=0, turn_command=0;
+float rotation_left=0, rotation_right=0;
+unsigned long last_task_time_PID=0, last_task_time_telemetry=0;
+
+// Filter states, used only inside the Timer 3 and Timer 1 ISRs
+float accel_angle=0, gyro_angle=0, tilt_angle=0, yaw_angle=0;
+float left_prev_count=0, right_prev_count=0;
+
+// Sensor state snapshot, taken at the start of every control tick
+RobotState robot = {0, 0, 0, 0, 0, 0, 0, 0};
 
 // Flags
 bool STOP_FLAG = true;
 bool ROTATION_FLAG = false;
 bool SLOPE_FLAG = false;
-
-// PID Structure Definition
-typedef struct PID
-{
-	volatile float con_KP;			// Conservative proportional gain
-	volatile float con_KI;			// Conservative integral gain
-	volatile float con_KD;			// Conservative derivative gain
-	
-	volatile float agr_KP;			// Aggressive proportional gain
-	volatile float agr_KI;			// Aggressive integral gain
-	volatile float agr_KD; 			// Aggressive derivative gain
-	
-	volatile float set_point;		// Set point value
-	volatile float error;			// Error value
-	volatile float position;		// Current position
-	volatile float last_position;	// Previous position
-	
-	volatile float integral;		// Integral sum
-	volatile float derivative;		// Derivative term
-	volatile float output; 			// PID output	
-	volatile int direction;			// Controller direction
-};
+bool YAW_INIT = false;
+bool MAG_TICK = false;
+bool MAG_CALIBRATED = false;
 
 // Structure Initializations
-PID angle    = {14, 3.2, 27, 20, 4, 32};
-PID velocity = {15, 0, 4, 5, 0, 0, 0};
-PID encoder  = {1.5, 0, 0, 8.2, 0, 0, 0};
+PID angle    = {ANGLE_GAINS};
+PID velocity = {VELOCITY_GAINS, 0};
+PID encoder  = {ENCODER_GAINS, 0};
+PID heading  = {3, 0, 0.15, 3, 0, 0.15, 0};
+MotionProfile drive_profile = {0, 0, 0, DRIVE_MAX_ACCEL, DRIVE_MAX_JERK};
 
 
 // Function Definitions
 
-/**********************************
-Function name	:	encoder_count
-Functionality	:	Returns the current encoder count
-Arguments		:	None
-Return Value	:	Encoder count sum
-Example Call	:	encoder_count()
-***********************************/
-float encoder_count();
-
 /**********************************
 Function name	:	complimentary_filter
 Functionality	:	First order complimentary filter for sensor fusion
@@ -117,9 +109,37 @@ Example Call	:	read_tilt_angle()
 ***********************************/
 void read_tilt_angle();
 
+/**********************************
+Function name	:	wrap_angle
+Functionality	:	To wrap an angle to the -180 to 180 degree range
+Arguments		:	Angle in degrees
+Return Value	:	Wrapped angle
+Example Call	:	wrap_angle(yaw_angle + 5)
+***********************************/
+float wrap_angle(float value);
+
+/**********************************
+Function name	:	read_yaw_angle
+Functionality	:	Compute the heading by integrating the gyroscope yaw rate and correcting
+					the drift with the magnetometer heading, starts the next magnetometer read
+Arguments		:	None
+Return Value	:	None
+Example Call	:	read_yaw_angle()
+***********************************/
+void read_yaw_angle();
+
+/**********************************
+Function name	:	rate_limit
+Functionality	:	To move a value towards a target by at most a fixed step
+Arguments		:	Current value, Target value, Maximum step
+Return Value	:	Rate limited value
+Example Call	:	rate_limit(turn_command, 1.0, TURN_RATE_LIMIT)
+***********************************/
+float rate_limit(float value, float target, float max_step);
+
 /**********************************
 Function name	:	handle_buttons
-Functionality	:	To handle the button inputs of the Joystick Controller 
+Functionality	:	To handle the Y-Axis and button inputs of the Joystick Controller 
 					and update the status/motion of the robot accordingly
 Arguments		:	None
 Return Value	:	None
@@ -130,6 +150,7 @@ void handle_buttons();
 /**********************************
 Function name	:	steer_robot
 Functionality	:	To set the direction, speed and the status of the robot
+					from the proportional joystick commands
 Arguments		:	None
 Return Value	:	None
 Example Call	:	steer_robot()
@@ -138,8 +159,8 @@ void steer_robot();
 
 /**********************************
 Function name	:	compute_rotation_PID
-Functionality	:	To prevent the rotational drift of the robot during static balance using a 
-					simple Proportional controller to minimize difference in encoder counts
+Functionality	:	To hold the heading of the robot when it is not being turned using a
+					PD controller on the fused yaw angle, independent of wheel slip
 Arguments		:	None
 Return Value	:	None
 Example Call	:	compute_rotation_PID()
@@ -191,6 +212,15 @@ Example Call	:	compute_PID()
 ***********************************/
 void compute_PID();
 
+/**********************************
+Function name	:	send_telemetry
+Functionality	:	To send the robot status to the telemetry XBee address
+Arguments		:	None
+Return Value	:	None
+Example Call	:	send_telemetry()
+***********************************/
+void send_telemetry();
+
 /**********************************
 Function name	:	task_scheduler
 Functionality	:	To schedule various tasks
@@ -0,0 +1,96 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: battery.cpp
+*
+* Created: 19-Oct-26 4:07:23 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for battery voltage monitoring and motor voltage compensation
+*
+* Functions: battery_init, battery_update, battery_voltage,
+* battery_compensation, battery_low
+*
+* Global Variables: battery_filter, battery_volts, battery_gain, LOW_BATTERY
+*/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "battery.h"
+
+// Filtered ADC value (16 times the average), 0 until the first conversion
+volatile unsigned int battery_filter = 0;
+
+float battery_volts = BATTERY_NOMINAL;
+float battery_gain = 1.0;
+bool LOW_BATTERY = false;
+
+/**********************************
+Function name	:	battery_init
+Functionality	:	To configure the ADC for interrupt driven battery voltage conversions
+Arguments		:	None
+Return Value	:	None
+Example Call	:	battery_init()
+***********************************/
+void battery_init()
+{
+	ADMUX  = 0x40 | BATTERY_ADC_CHANNEL;	// AVCC reference, right adjusted, channel 0-7
+	ADCSRB = 0x00;							// MUX5 = 0
+	DIDR0  = 1 << BATTERY_ADC_CHANNEL;		// Disable digital input buffer
+	ADCSRA = 0x8F;							// Enable ADC and interrupt, Prescaler 128 (115.2kHz)
+}
+
+/**********************************
+Function name	:	ISR(ADC_vect)
+Functionality	:	ISR for ADC conversion complete, first order low pass filter
+Arguments		:	ADC conversion complete vector
+Return Value	:	None
+Example Call	:	Called automatically
+***********************************/
+ISR(ADC_vect)
+{
+	unsigned int sample = ADC;
+	
+	// filter = 16*average, time constant of 16 conversions
+	if (battery_filter == 0) battery_filter = sample << 4;
+	else battery_filter += sample - (battery_filter >> 4);
+}
+
+/**********************************
+Function name	:	battery_update
+Functionality	:	To start the next ADC conversion and update the battery voltage,
+					compensation factor and low battery state from the filtered samples
+Arguments		:	None
+Return Value	:	None
+Example Call	:	battery_update()
+***********************************/
+void battery_update()
+{
+	unsigned int filter;
+	unsigned char sreg = SREG;
+	
+	// Start the next conversion, the result arrives in ISR(ADC_vect)
+	if (!(ADCSRA & 0x40)) ADCSRA |= 0x40;
+	
+	cli();
+	filter = battery_filter;
+	SREG = sreg;
+	if (filter == 0) return;
+	
+	battery_volts = (filter/16.0)*(ADC_REFERENCE/1024.0)*BATTERY_DIVIDER;
+	
+	// Scale the motor command up as the battery sags and down on a fresh charge
+	battery_gain = BATTERY_NOMINAL/battery_volts;
+	if (battery_gain > BATTERY_MAX_COMPENSATION) battery_gain = BATTERY_MAX_COMPENSATION;
+	
+	// Low battery state with hysteresis
+	if (battery_volts < BATTERY_LOW) LOW_BATTERY = true;
+	else if (battery_volts > BATTERY_LOW_CLEAR) LOW_BATTERY = false;
+}
+
+// Getter functions
+float battery_voltage() {return battery_volts;}
+float battery_compensation() {return battery_gain;}
+bool battery_low() {return LOW_BATTERY;}
\ No newline at end of file
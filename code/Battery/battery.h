@@ -0,0 +1,77 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: battery.h
+*
+* Created: 19-Oct-26 4:07:23 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for battery voltage monitoring and motor voltage compensation
+*/
+
+#ifndef BATTERY_H_
+#define BATTERY_H_
+
+// Battery Sense Input
+#define BATTERY_ADC_CHANNEL			0		// ADC0 - PF0 (A0)
+#define BATTERY_DIVIDER				2.0		// Resistor divider ratio (battery/ADC pin)
+#define ADC_REFERENCE				5.0		// AVCC reference voltage
+
+// Battery Thresholds (V)
+#define BATTERY_NOMINAL				3.9		// Voltage at which the controller gains were tuned
+#define BATTERY_LOW					3.5		// Low battery warning
+#define BATTERY_LOW_CLEAR			3.6		// Low battery warning hysteresis
+#define BATTERY_MAX_COMPENSATION	1.3		// Largest PWM scale factor applied
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	battery_init
+Functionality	:	To configure the ADC for interrupt driven battery voltage conversions
+Arguments		:	None
+Return Value	:	None
+Example Call	:	battery_init()
+***********************************/
+void battery_init();
+
+/**********************************
+Function name	:	battery_update
+Functionality	:	To start the next ADC conversion and update the battery voltage,
+					compensation factor and low battery state from the filtered samples
+Arguments		:	None
+Return Value	:	None
+Example Call	:	battery_update()
+***********************************/
+void battery_update();
+
+/**********************************
+Function name	:	battery_voltage
+Functionality	:	Returns the filtered battery voltage
+Arguments		:	None
+Return Value	:	Battery voltage (V)
+Example Call	:	battery_voltage()
+***********************************/
+float battery_voltage();
+
+/**********************************
+Function name	:	battery_compensation
+Functionality	:	Returns the PWM scale factor for a constant effective motor voltage
+Arguments		:	None
+Return Value	:	Scale factor (below 1 above BATTERY_NOMINAL, up to BATTERY_MAX_COMPENSATION)
+Example Call	:	battery_compensation()
+***********************************/
+float battery_compensation();
+
+/**********************************
+Function name	:	battery_low
+Functionality	:	Returns the low battery state
+Arguments		:	None
+Return Value	:	True if the battery voltage is low
+Example Call	:	battery_low()
+***********************************/
+bool battery_low();
+
+#endif
\ No newline at end of file
@@ -10,15 +10,18 @@
 *
 * Library for the Joystick Controller
 *
-* Functions: read_joystick, get_joystick_zone
-* Global Variables: joystick
+* Functions: read_joystick, get_joystick_zone, get_joystick_command, xbee_parse_byte,
+* xbee_handle_io_sample, xbee_handle_frame, xbee_write_byte, xbee_send_data
+*
+* Global Variables: joystick, xbee
 */
 
-#include <Arduino.h>
+#include "../Support/platform.h"
 #include "controller.h"
 
 // Structure Initialization
-JoystickController joystick = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+JoystickController joystick = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+XBeeParser xbee = {XBEE_WAIT_START};
 
 /**********************************
 Function name	:	get_joystick_zone
@@ -47,6 +50,224 @@ int get_joystick_zone(unsigned char low_byte, unsigned char high_byte, int offse
 	return zone;
 }
 
+/**********************************
+Function name	:	get_joystick_command
+Functionality	:	To map the Joystick ADC input value to a proportional command
+					with a deadband around the centre and an expo curve
+Arguments		:	10-bit ADC value, Offset ADC value
+Return Value	:	Command value from -1 to 1
+Example Call	:	get_joystick_command(768, 9)
+***********************************/
+float get_joystick_command(unsigned int value, int offset)
+{
+	float command=0, magnitude=0;
+	
+	// Normalize the centred ADC value to -1 to 1 range
+	command = ((float)value - offset - 511.5) / 511.5;
+	command = constrain(command, -1.0, 1.0);
+	
+	// Remove the deadband and rescale the remaining travel to 0 to 1
+	magnitude = abs(command);
+	if (magnitude <= JOYSTICK_DEADBAND) return 0;
+	magnitude = (magnitude - JOYSTICK_DEADBAND) / (1.0 - JOYSTICK_DEADBAND);
+	
+	// Expo curve for finer control around the centre
+	magnitude = (1.0 - JOYSTICK_EXPO)*magnitude + JOYSTICK_EXPO*magnitude*magnitude*magnitude;
+	
+	return (command < 0) ? -magnitude : magnitude;
+}
+
+/**********************************
+Function name	:	xbee_parse_byte
+Functionality	:	To run one step of the XBee API frame parser state machine.
+					Re-synchronises on the start delimiter, honours the length
+					field, removes escape characters in API mode 2 and validates
+					the checksum of every frame
+Arguments		:	Received byte
+Return Value	:	True when a complete valid frame is available in xbee.frame
+Example Call	:	xbee_parse_byte(Serial.read())
+***********************************/
+bool xbee_parse_byte(unsigned char data)
+{
+#if XBEE_API_MODE == 2
+	// Escaped mode: an unescaped delimiter always starts a new frame
+	if (data == XBEE_START_DELIMITER)
+	{
+		if (xbee.state != XBEE_WAIT_START) xbee.bad_frames++;
+		xbee.state = XBEE_LENGTH_MSB;
+		xbee.escape = false;
+		return false;
+	}
+	
+	// Escaped bytes follow 0x7D and are XOR'ed with 0x20
+	if (data == XBEE_ESCAPE)
+	{
+		xbee.escape = true;
+		return false;
+	}
+	
+	if (xbee.escape)
+	{
+		data ^= 0x20;
+		xbee.escape = false;
+	}
+#endif
+	
+	switch (xbee.state)
+	{
+		// Discard everything until the start of the next frame
+		case XBEE_WAIT_START:
+			if (data == XBEE_START_DELIMITER) xbee.state = XBEE_LENGTH_MSB;
+		break;
+		
+		// A start delimiter can never be a valid length byte (frames are shorter
+		// than 0x7E bytes), so it is treated as the start of a new frame
+		case XBEE_LENGTH_MSB:
+			if (data == XBEE_START_DELIMITER) break;
+			xbee.length = (unsigned int)data << 8;
+			xbee.state = XBEE_LENGTH_LSB;
+		break;
+		
+		case XBEE_LENGTH_LSB:
+			if (data == XBEE_START_DELIMITER)
+			{
+				xbee.bad_frames++;
+				xbee.state = XBEE_LENGTH_MSB;
+				break;
+			}
+			xbee.length |= data;
+			
+			// Drop frames which cannot fit in the buffer and resync
+			if ((xbee.length == 0) || (xbee.length > XBEE_MAX_FRAME_SIZE))
+			{
+				xbee.bad_frames++;
+				xbee.state = XBEE_WAIT_START;
+				break;
+			}
+			
+			xbee.index = 0;
+			xbee.checksum = 0;
+			xbee.state = XBEE_FRAME_DATA;
+		break;
+		
+		// Store the API ID and frame data
+		case XBEE_FRAME_DATA:
+			xbee.frame[xbee.index++] = data;
+			xbee.checksum += data;
+			if (xbee.index >= xbee.length) xbee.state = XBEE_CHECKSUM;
+		break;
+		
+		// Sum of frame data and checksum must be 0xFF
+		case XBEE_CHECKSUM:
+			xbee.state = XBEE_WAIT_START;
+			if ((unsigned char)(xbee.checksum + data) == 0xFF)
+			{
+				xbee.good_frames++;
+				return true;
+			}
+			xbee.bad_frames++;
+		break;
+		
+		default:
+			xbee.state = XBEE_WAIT_START;
+		break;
+	}
+	
+	return false;
+}
+
+/**********************************
+Function name	:	xbee_handle_io_sample
+Functionality	:	To decode the I/O samples of an RX I/O frame and update the controller.
+					Analog values are averaged over all samples in the frame and a
+					button is pressed if it is pressed in any of the samples
+Arguments		:	Pointer to the sample header (sample count byte), bytes available
+Return Value	:	None
+Example Call	:	xbee_handle_io_sample(&xbee.frame[5], xbee.length - 5)
+***********************************/
+void xbee_handle_io_sample(const unsigned char *sample, unsigned int size)
+{
+	unsigned int channels=0, index=3, ADC_sum[6]={0, 0, 0, 0, 0, 0};
+	unsigned char samples=0, digital_data=0;
+	
+	// Sample count and channel indicator
+	if (size < 3) return;
+	samples = sample[0];
+	channels = ((unsigned int)sample[1] << 8) | sample[2];
+	if (samples == 0) return;
+	
+	for (unsigned char n=0; n<samples; n++)
+	{
+		// Digital data (D0-D8) is present only if any digital line is enabled
+		if (channels & 0x01FF)
+		{
+			if ((index + 2) > size) return;
+			digital_data |= sample[index+1];
+			index += 2;
+		}
+		
+		// Analog data (A0-A5) for every enabled channel in ascending order
+		for (int i=0; i<6; i++)
+		{
+			if (!(channels & (0x0200 << i))) continue;
+			if ((index + 2) > size) return;
+			ADC_sum[i] += ((unsigned int)sample[index] << 8) | sample[index+1];
+			index += 2;
+		}
+	}
+	
+	// Average the analog samples (the frame size keeps the 10-bit sums within 16 bits)
+	for (int i=0; i<6; i++) ADC_sum[i] /= samples;
+	
+	// Update Controller Variables
+	if ((digital_data & 0x40) == 0x40) joystick.button_1 = HIGH;
+	else joystick.button_1 = LOW;
+	
+	if ((digital_data & 0x08) == 0x08) joystick.button_2 = HIGH;
+	else joystick.button_2 = LOW;
+	
+	if ((digital_data & 0x10) == 0x10) joystick.button_3 = HIGH;
+	else joystick.button_3 = LOW;
+	
+	if ((digital_data & 0x04) == 0x04) joystick.button_4 = HIGH;
+	else joystick.button_4 = LOW;
+	
+	// Map ADC values to Zones
+	joystick.x_position = get_joystick_zone(ADC_sum[1] & 0xFF, ADC_sum[1] >> 8, 9);
+	joystick.y_position = get_joystick_zone(ADC_sum[0] & 0xFF, ADC_sum[0] >> 8, 20);
+	
+	// Map ADC values to proportional commands
+	joystick.x_command = get_joystick_command(ADC_sum[1], 9);
+	joystick.y_command = get_joystick_command(ADC_sum[0], 20);
+}
+
+/**********************************
+Function name	:	xbee_handle_frame
+Functionality	:	To dispatch a complete XBee API frame based on its frame type
+Arguments		:	None
+Return Value	:	None
+Example Call	:	xbee_handle_frame()
+***********************************/
+void xbee_handle_frame()
+{
+	switch (xbee.frame[0])
+	{
+		// API ID, Source Address (2), RSSI, Options
+		case XBEE_RX_IO_16BIT:
+			if (xbee.length > 5) xbee_handle_io_sample(&xbee.frame[5], xbee.length - 5);
+		break;
+		
+		// API ID, Source Address (8), RSSI, Options
+		case XBEE_RX_IO_64BIT:
+			if (xbee.length > 11) xbee_handle_io_sample(&xbee.frame[11], xbee.length - 11);
+		break;
+		
+		default:
+			xbee.unknown_frames++;
+		break;
+	}
+}
+
 /**********************************
 Function name	:	read_joystick
 Functionality	:	To read the data from the controller XBee Module and store it
@@ -56,62 +277,62 @@ Example Call	:	read_joystick()
 ***********************************/
 void read_joystick()
 {
-	int sum = 131;
-	unsigned char byte_discard, checksum;
-	unsigned char digital_data = 0;
-	unsigned char AD0[2]={0, 0}, AD1[2]={0, 0};
+	// Feed every received byte to the parser, frames are handled as soon as they complete
+	while (Serial.available() > 0)
+	{
+		if (xbee_parse_byte((unsigned char)Serial.read())) xbee_handle_frame();
+	}
+}
+
+/**********************************
+Function name	:	xbee_write_byte
+Functionality	:	To write one byte of an API frame, escaping it in API mode 2
+Arguments		:	Byte to be written
+Return Value	:	None
+Example Call	:	xbee_write_byte(0x13)
+***********************************/
+void xbee_write_byte(unsigned char data)
+{
+	#if XBEE_API_MODE == 2
+	if ((data == XBEE_START_DELIMITER) || (data == XBEE_ESCAPE) || (data == 0x11) || (data == 0x13))
+	{
+		Serial.write(XBEE_ESCAPE);
+		data ^= 0x20;
+	}
+	#endif
 	
-	// Check frame length
-	if (Serial.available() > 18)
+	Serial.write(data);
+}
+
+/**********************************
+Function name	:	xbee_send_data
+Functionality	:	To send a payload to XBEE_TELEMETRY_ADDRESS in a TX Request frame
+Arguments		:	Pointer to the payload, payload length
+Return Value	:	None
+Example Call	:	xbee_send_data(packet, 4)
+***********************************/
+void xbee_send_data(const unsigned char *data, unsigned char length)
+{
+	// API ID, Frame ID, Destination Address (2), Options
+	unsigned char header[5] = {XBEE_TX_REQUEST_16BIT, 0x00, XBEE_TELEMETRY_ADDRESS >> 8, XBEE_TELEMETRY_ADDRESS & 0xFF, 0x01};
+	unsigned char checksum = 0;
+	
+	// Start delimiter is never escaped
+	Serial.write(XBEE_START_DELIMITER);
+	xbee_write_byte(0);
+	xbee_write_byte(length + 5);
+	
+	for (int i=0; i<5; i++)
 	{
-		// Check Start Byte of the API Frame
-		if (Serial.read() == 0x7E)
-		{
-			// Read and discard 2 bytes
-			for (int i=0; i<2; i++)
-			byte_discard = Serial.read();
-			
-			// Check Frame Type
-			if(Serial.read() != 0x83) return;
-			
-			// Read and discard 8 bytes
-			for (int i=0; i<8; i++)
-			sum += Serial.read();
-			
-			// Read Digital Byte
-			digital_data = Serial.read();
-			sum += digital_data;
-			
-			// Read ADC Data
-			AD0[1] = Serial.read();
-			AD0[0] = Serial.read();
-			AD1[1] = Serial.read();
-			AD1[0] = Serial.read();
-			sum = sum + AD0[0] + AD0[1] + AD1[0] + AD1[1];
-			
-			// Read Checksum
-			checksum = 0xFF - (0xFF & (unsigned char)sum);
-			byte_discard = Serial.read();
-			
-			// Discard frame if checksum does not match
-			if (byte_discard != checksum) return;
-			
-			// Update Controller Variables
-			if ((digital_data & 0x40) == 0x40) joystick.button_1 = HIGH;
-			else joystick.button_1 = LOW;
-			
-			if ((digital_data & 0x08) == 0x08) joystick.button_2 = HIGH;
-			else joystick.button_2 = LOW;
-			
-			if ((digital_data & 0x10) == 0x10) joystick.button_3 = HIGH;
-			else joystick.button_3 = LOW;
-			
-			if ((digital_data & 0x04) == 0x04) joystick.button_4 = HIGH;
-			else joystick.button_4 = LOW;
-			
-			// Map ADC values to Zones
-			joystick.x_position = get_joystick_zone(AD1[0], AD1[1], 9);
-			joystick.y_position = get_joystick_zone(AD0[0], AD0[1], 20);
-		}
+		xbee_write_byte(header[i]);
+		checksum += header[i];
 	}
+	
+	for (int i=0; i<length; i++)
+	{
+		xbee_write_byte(data[i]);
+		checksum += data[i];
+	}
+	
+	xbee_write_byte(0xFF - checksum);
 }
\ No newline at end of file
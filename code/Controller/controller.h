@@ -14,12 +14,40 @@
 #ifndef CONTROLLER_H_
 #define CONTROLLER_H_
 
+// XBee API Mode (AP parameter of the robot XBee)
+// 1 - API mode without escaped characters
+// 2 - API mode with escaped characters
+#define XBEE_API_MODE			1
+
+// XBee API Frame Definitions
+#define XBEE_START_DELIMITER	0x7E
+#define XBEE_ESCAPE				0x7D	// Escape character, next byte is XOR'ed with 0x20
+#define XBEE_TX_REQUEST_16BIT	0x01	// TX Request Frame, 16-bit destination address
+#define XBEE_RX_IO_64BIT		0x82	// RX I/O Data Frame, 64-bit source address
+#define XBEE_RX_IO_16BIT		0x83	// RX I/O Data Frame, 16-bit source address
+#define XBEE_MAX_FRAME_SIZE		100		// Largest frame data (API ID to last byte) accepted
+#define XBEE_TELEMETRY_ADDRESS	0xFFFF	// Destination of telemetry frames (broadcast)
+
+// XBee Parser States
+#define XBEE_WAIT_START			0		// Discard bytes until a start delimiter is seen
+#define XBEE_LENGTH_MSB			1		// Frame length high byte
+#define XBEE_LENGTH_LSB			2		// Frame length low byte
+#define XBEE_FRAME_DATA			3		// API ID and frame data
+#define XBEE_CHECKSUM			4		// Frame checksum
+
+// Joystick Command Shaping
+#define JOYSTICK_DEADBAND		0.2		// Fraction of travel around centre mapped to zero
+#define JOYSTICK_EXPO			0.6		// 0 - Linear, 1 - Cubic response around centre
+
 // Structure to handle the various inputs from the controller
 typedef struct JoystickController
 {
 	int x_position;		// Joystick X-Axis ADC Value
 	int y_position;		// Joystick Y-Axis ADC Value
 	
+	float x_command;	// Joystick X-Axis proportional command (-1 to 1)
+	float y_command;	// Joystick Y-Axis proportional command (-1 to 1)
+	
 	bool button_1;		// Push Button 1 Value
 	bool button_2;		// Push Button 2 Value
 	bool button_3;		// Push Button 3 Value
@@ -32,7 +60,24 @@ typedef struct JoystickController
 	unsigned long b4_time;
 };
 
+// Structure to hold the state of the XBee API frame parser
+typedef struct XBeeParser
+{
+	unsigned char state;						// Current parser state
+	unsigned int length;						// Frame length from the length field
+	unsigned int index;							// Number of frame data bytes received
+	unsigned char checksum;						// Running checksum of the frame data
+	bool escape;								// Next byte is escaped (API mode 2)
+	unsigned char frame[XBEE_MAX_FRAME_SIZE];	// Frame data (API ID onwards)
+	
+	// Frame statistics
+	unsigned int good_frames;					// Frames with a valid checksum
+	unsigned int bad_frames;					// Frames with a bad checksum or length
+	unsigned int unknown_frames;				// Valid frames of an unsupported type
+};
+
 extern JoystickController joystick;
+extern XBeeParser xbee;
 
 
 // Function Declarations
@@ -46,6 +91,48 @@ Example Call	:	get_joystick_zone(255, 10, 22)
 ***********************************/
 int get_joystick_zone(unsigned char low_byte, unsigned char high_byte, int offset);
 
+/**********************************
+Function name	:	get_joystick_command
+Functionality	:	To map the Joystick ADC input value to a proportional command
+					with a deadband around the centre and an expo curve
+Arguments		:	10-bit ADC value, Offset ADC value
+Return Value	:	Command value from -1 to 1
+Example Call	:	get_joystick_command(768, 9)
+***********************************/
+float get_joystick_command(unsigned int value, int offset);
+
+/**********************************
+Function name	:	xbee_parse_byte
+Functionality	:	To run one step of the XBee API frame parser state machine.
+					Re-synchronises on the start delimiter, honours the length
+					field, removes escape characters in API mode 2 and validates
+					the checksum of every frame
+Arguments		:	Received byte
+Return Value	:	True when a complete valid frame is available in xbee.frame
+Example Call	:	xbee_parse_byte(Serial.read())
+***********************************/
+bool xbee_parse_byte(unsigned char data);
+
+/**********************************
+Function name	:	xbee_handle_io_sample
+Functionality	:	To decode the I/O samples of an RX I/O frame and update the controller.
+					Analog values are averaged over all samples in the frame and a
+					button is pressed if it is pressed in any of the samples
+Arguments		:	Pointer to the sample header (sample count byte), bytes available
+Return Value	:	None
+Example Call	:	xbee_handle_io_sample(&xbee.frame[5], xbee.length - 5)
+***********************************/
+void xbee_handle_io_sample(const unsigned char *sample, unsigned int size);
+
+/**********************************
+Function name	:	xbee_handle_frame
+Functionality	:	To dispatch a complete XBee API frame based on its frame type
+Arguments		:	None
+Return Value	:	None
+Example Call	:	xbee_handle_frame()
+***********************************/
+void xbee_handle_frame();
+
 /**********************************
 Function name	:	read_joystick
 Functionality	:	To read the data from the controller XBee Module and store it
@@ -55,4 +142,22 @@ Example Call	:	read_joystick()
 ***********************************/
 void read_joystick();
 
+/**********************************
+Function name	:	xbee_write_byte
+Functionality	:	To write one byte of an API frame, escaping it in API mode 2
+Arguments		:	Byte to be written
+Return Value	:	None
+Example Call	:	xbee_write_byte(0x13)
+***********************************/
+void xbee_write_byte(unsigned char data);
+
+/**********************************
+Function name	:	xbee_send_data
+Functionality	:	To send a payload to XBEE_TELEMETRY_ADDRESS in a TX Request frame
+Arguments		:	Pointer to the payload, payload length
+Return Value	:	None
+Example Call	:	xbee_send_data(packet, 4)
+***********************************/
+void xbee_send_data(const unsigned char *data, unsigned char length);
+
 #endif
\ No newline at end of file
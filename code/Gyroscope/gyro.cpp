@@ -10,20 +10,29 @@
 *
 * Library for L3G4200D Gyroscope
 *
-* Functions: gyro_init(), convert_gyro(), read_gyro(), get_gyro_angle(), calibrate_gyro()
-* Global Variables: last_time, x_offset, y_offset, z_offset
+* Functions: gyro_init(), convert_gyro(), read_gyro(), read_yaw_rate(), get_gyro_angle(), calibrate_gyro(),
+* update_gyro_bias(), gyro_calibrated(), read_gyro_temp(), compensate_gyro_temp(), record_gyro_temp(),
+* save_gyro_temp()
+* Global Variables: last_time, yaw_rate, gyro_bias, gyro_temp, gyro_temp_eeprom
 */
 
+#include <math.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/eeprom.h>
 #include "../I2C/i2c_lib.h"
 #include "../Support/support_lib.h"
 #include "gyro.h"
 
 volatile unsigned long last_time = 0;
+float yaw_rate = 0;
 
-// Gyroscope Offsets
-//float x_offset = -0.04372;
-const float y_offset = 0.93170;
-//float z_offset = 0.28436;
+// Gyroscope offsets, measured at start-up and refined while still
+GyroBias gyro_bias = {{GYRO_Y_OFFSET, GYRO_Z_OFFSET}, {0, 0}, {0, 0}, 0, 0, 0, false};
+
+// Bias against temperature, erased (0xFF) until a table is recorded
+GyroTemp gyro_temp;
+GyroTempTable gyro_temp_eeprom EEMEM;
 
 /**********************************
 Function name	:	gyro_init
@@ -35,30 +44,267 @@ Example Call	:	gyro_init()
 void gyro_init()
 {
 	check_device_ID(L3G4200D_ADDRESS, L3G4200D_WHO_AM_I, L3G4200D_KNOWN_ID);	// Verify Device ID
-	check_status(i2c_sendbyte(L3G4200D_ADDRESS, L3G4200D_CTRL_REG1, 0x1F));		// 100Hz, 25Hz, Normal Mode
+	check_status(i2c_sendbyte(L3G4200D_ADDRESS, L3G4200D_CTRL_REG1, 0xFF));		// 800Hz, 110Hz, Normal Mode for the calibration
 	check_status(i2c_sendbyte(L3G4200D_ADDRESS, L3G4200D_CTRL_REG4, 0xB0));		// 2000dps
+	check_status(i2c_sendbyte(L3G4200D_ADDRESS, L3G4200D_CTRL_REG5, 0x40));		// FIFO enabled
+	check_status(i2c_sendbyte(L3G4200D_ADDRESS, L3G4200D_FIFO_CTRL_REG, 0x40));	// Stream mode
+	
+	// With a recorded table the offsets are only what the table leaves
+	eeprom_read_block(&gyro_temp.table, &gyro_temp_eeprom, sizeof(GyroTempTable));
+	compensate_gyro_temp(read_gyro_temp());
+	#ifndef GYRO_TEMP_CALIBRATE
+	if (gyro_temp.table.magic == GYRO_TEMP_MAGIC) gyro_bias.offset[0] = gyro_bias.offset[1] = 0;
+	#endif
+}
+
+/**********************************
+Function name	:	read_gyro_temp
+Functionality	:	To read the temperature of the gyroscope on its own
+Arguments		:	none
+Return Value	:	Temperature (deg C, no fixed offset)
+Example Call	:	read_gyro_temp()
+***********************************/
+int read_gyro_temp()
+{
+	INT8 temperature = 0;
+	
+	// -1 LSB/deg C
+	check_status(i2c_getbyte(L3G4200D_ADDRESS, L3G4200D_OUT_TEMP, &temperature));
+	return -temperature;
+}
+
+/**********************************
+Function name	:	compensate_gyro_temp
+Functionality	:	Interpolates the Y and Z bias at a temperature between the recorded
+					points of the table, the end points are held beyond it
+Arguments		:	Temperature (deg C)
+Return Value	:	void
+Example Call	:	compensate_gyro_temp(read_gyro_temp())
+***********************************/
+void compensate_gyro_temp(int temperature)
+{
+	GyroTempTable *table = &gyro_temp.table;
+	float position = 0, t = 0;
+	int below = -1, above = -1;
+	
+	gyro_temp.temperature = temperature;
+	gyro_temp.bias[0] = gyro_temp.bias[1] = 0;
+	
+	// The table being recorded is not applied
+	#ifdef GYRO_TEMP_CALIBRATE
+	return;
+	#endif
+	if (table->magic != GYRO_TEMP_MAGIC) return;
+	
+	// Nearest recorded points on both sides
+	position = (float)(temperature - table->base)/GYRO_TEMP_STEP;
+	for (int i=0; i<GYRO_TEMP_POINTS; i++)
+	{
+		if (!(table->valid & (1 << i))) continue;
+		if (i <= position) below = i;
+		if ((i >= position) && (above < 0)) above = i;
+	}
+	if (below < 0) below = above;
+	if (above < 0) above = below;
+	if (below < 0) return;
+	
+	if (above != below) t = (position - below)/(above - below);
+	for (int axis=0; axis<2; axis++)
+	{
+		gyro_temp.bias[axis] = 0.001*(table->bias[below][axis] + t*(table->bias[above][axis] - table->bias[below][axis]));
+	}
+}
+
+/**********************************
+Function name	:	record_gyro_temp
+Functionality	:	Averages still rates into the nearest point of the table, the point is
+					stored after GYRO_TEMP_SAMPLES and the table marked to be saved
+Arguments		:	Y and Z angular velocity without any offset removed (DPS)
+Return Value	:	void
+Example Call	:	record_gyro_temp(y_rate, z_rate)
+***********************************/
+void record_gyro_temp(float y_rate, float z_rate)
+{
+	GyroTempTable *table = &gyro_temp.table;
+	int point = 0;
+	
+	// A new table starts a point below the first temperature, in case the board cools
+	if (table->magic != GYRO_TEMP_MAGIC)
+	{
+		table->magic = GYRO_TEMP_MAGIC;
+		table->base = gyro_temp.temperature - GYRO_TEMP_STEP;
+		table->valid = 0;
+		gyro_temp.point = -1;
+	}
+	
+	// Nearest point, its average restarts when the temperature moves to another
+	point = gyro_temp.temperature - table->base + GYRO_TEMP_STEP/2;
+	if (point < 0) return;
+	point /= GYRO_TEMP_STEP;
+	if (point >= GYRO_TEMP_POINTS) return;
+	if (point != gyro_temp.point)
+	{
+		gyro_temp.point = point;
+		gyro_temp.sum[0] = gyro_temp.sum[1] = 0;
+		gyro_temp.samples = 0;
+	}
+	
+	gyro_temp.sum[0] += y_rate;
+	gyro_temp.sum[1] += z_rate;
+	gyro_temp.samples++;
+	if (gyro_temp.samples < GYRO_TEMP_SAMPLES) return;
+	
+	// Store the point (0.001 DPS) and measure it again
+	table->bias[point][0] = 1000*gyro_temp.sum[0]/gyro_temp.samples;
+	table->bias[point][1] = 1000*gyro_temp.sum[1]/gyro_temp.samples;
+	table->valid |= 1 << point;
+	gyro_temp.sum[0] = gyro_temp.sum[1] = 0;
+	gyro_temp.samples = 0;
+	gyro_temp.dirty = true;
+}
+
+/**********************************
+Function name	:	save_gyro_temp
+Functionality	:	Writes the table to the EEPROM if a point was recorded. Blocks for 3.4ms
+					per changed byte, call it from the telemetry task
+Arguments		:	none
+Return Value	:	void
+Example Call	:	save_gyro_temp()
+***********************************/
+void save_gyro_temp()
+{
+	GyroTempTable table;
+	unsigned char sreg = SREG;
+	
+	if (!gyro_temp.dirty) return;
+	
+	// Copy the table away from the Timer 3 ISR, only the changed bytes are written
+	cli();
+	table = gyro_temp.table;
+	gyro_temp.dirty = false;
+	SREG = sreg;
+	eeprom_update_block(&table, &gyro_temp_eeprom, sizeof(GyroTempTable));
 }
 
 /**********************************
 Function name	:	calibrate_gyro
-Functionality	:	Reads values of Gyroscope when static, computes average offset
+Functionality	:	Reads a burst of the FIFO and averages it into the offsets while the
+					robot is still, a movement restarts the average. Switches the gyroscope
+					back to 100Hz without the FIFO when done
 Arguments		:	None
 Return Value	:	void
 Example Call	:	calibrate_gyro()
 ***********************************/
-/*void calibrate_gyro()
+void calibrate_gyro()
 {
-	int n=0;
-	float xsum=0, ysum=0, zsum=0;
-	while(n<1000)
+	INT8 fifo[6*GYRO_BURST];
+	INT8 source = 0;
+	INT16 value = 0, low[2] = {32767, 32767}, high[2] = {-32768, -32768};
+	long burst[2] = {0, 0};
+	int count = 0;
+	bool still = true;
+	
+	// Unread samples, 32 when the FIFO has overrun
+	check_status(i2c_getbyte(L3G4200D_ADDRESS, L3G4200D_FIFO_SRC_REG, &source));
+	count = (source & 0x40) ? 32 : (source & 0x1F);
+	if (count > GYRO_BURST) count = GYRO_BURST;
+	if (count == 0) return;
+	
+	// OUT_X_L to OUT_Z_H of each sample, the address rolls back to OUT_X_L with the FIFO on
+	check_status(i2c_read_multi_byte(L3G4200D_ADDRESS, L3G4200D_OUT_X_L, 6*count, fifo));
+	for (int i=0; i<count; i++)
+	{
+		for (int axis=0; axis<2; axis++)
+		{
+			gyro_bias.raw[axis] = (UINT8)fifo[6*i + 2 + 2*axis] | (UINT8)fifo[6*i + 3 + 2*axis]<<8;
+			value = (INT16)gyro_bias.raw[axis];
+			burst[axis] += value;
+			if (value < low[axis]) low[axis] = value;
+			if (value > high[axis]) high[axis] = value;
+		}
+	}
+	gyro_bias.total += count;
+	
+	// Still if the burst is quiet and stays at the average so far
+	for (int axis=0; axis<2; axis++)
+	{
+		if ((high[axis] - low[axis]) > GYRO_STILL_SPREAD) still = false;
+		if (gyro_bias.samples && (fabs((float)burst[axis]/count - (float)gyro_bias.sum[axis]/gyro_bias.samples) > GYRO_STILL_SPREAD/2)) still = false;
+	}
+	
+	if (gyro_bias.total <= GYRO_SETTLE_SAMPLES) return;
+	if (!still)
+	{
+		gyro_bias.sum[0] = gyro_bias.sum[1] = 0;
+		gyro_bias.samples = 0;
+	}
+	else
 	{
-		read_gyro();
-		xsum += xg_rate;
-		ysum += yg_rate;
-		zsum += zg_rate;
-		n++;
+		gyro_bias.sum[0] += burst[0];
+		gyro_bias.sum[1] += burst[1];
+		gyro_bias.samples += count;
 	}
-}*/
+	
+	// Done, or keep the measured offsets if the robot was never still long enough.
+	// The offsets are what is left after the temperature compensation
+	if (gyro_bias.samples >= GYRO_CALIBRATION_SAMPLES)
+	{
+		compensate_gyro_temp(read_gyro_temp());
+		gyro_bias.offset[0] = 0.07*gyro_bias.sum[0]/gyro_bias.samples - gyro_temp.bias[0];
+		gyro_bias.offset[1] = 0.07*gyro_bias.sum[1]/gyro_bias.samples - gyro_temp.bias[1];
+	}
+	else if (gyro_bias.total < GYRO_CALIBRATION_TIMEOUT) return;
+	
+	check_status(i2c_sendbyte(L3G4200D_ADDRESS, L3G4200D_FIFO_CTRL_REG, 0x00));	// Bypass mode
+	check_status(i2c_sendbyte(L3G4200D_ADDRESS, L3G4200D_CTRL_REG5, 0x00));		// FIFO disabled
+	check_status(i2c_sendbyte(L3G4200D_ADDRESS, L3G4200D_CTRL_REG1, 0x1F));		// 100Hz, 25Hz, Normal Mode
+	gyro_bias.calibrated = true;
+}
+
+/**********************************
+Function name	:	update_gyro_bias
+Functionality	:	Refines the offsets with a slow filter once both rates have stayed
+					near them for GYRO_STILL_SAMPLES, tracks the drift as the sensor warms
+Arguments		:	Y and Z angular velocity without the offsets removed (DPS)
+Return Value	:	void
+Example Call	:	update_gyro_bias(y_rate, z_rate)
+***********************************/
+void update_gyro_bias(float y_rate, float z_rate)
+{
+	if (!gyro_bias.calibrated) return;
+	
+	// Any movement restarts the wait, a slow turn below GYRO_STILL_RATE is only
+	// partly taken as bias before the heading hold stops it
+	if ((fabs(y_rate - gyro_bias.offset[0]) > GYRO_STILL_RATE) || (fabs(z_rate - gyro_bias.offset[1]) > GYRO_STILL_RATE))
+	{
+		gyro_bias.still = 0;
+		return;
+	}
+	if (gyro_bias.still < GYRO_STILL_SAMPLES)
+	{
+		gyro_bias.still++;
+		return;
+	}
+	
+	gyro_bias.offset[0] += GYRO_BIAS_GAIN*(y_rate - gyro_bias.offset[0]);
+	gyro_bias.offset[1] += GYRO_BIAS_GAIN*(z_rate - gyro_bias.offset[1]);
+	
+	#ifdef GYRO_TEMP_CALIBRATE
+	record_gyro_temp(y_rate, z_rate);
+	#endif
+}
+
+/**********************************
+Function name	:	gyro_calibrated
+Functionality	:	Returns true once the start-up calibration is done or has timed out
+Arguments		:	none
+Return Value	:	Calibration state
+Example Call	:	gyro_calibrated()
+***********************************/
+bool gyro_calibrated()
+{
+	return gyro_bias.calibrated;
+}
 
 /**********************************
 Function name	:	convert_gyro
@@ -82,7 +328,8 @@ float convert_gyro(UINT16 value, float offset)
 
 /**********************************
 Function name	:	read_gyro
-Functionality	:	To read Y-axis angular velocity from Gyroscope
+Functionality	:	To read Y-axis angular velocity from Gyroscope, Z-axis (yaw) rate is
+					read in the same burst and stored for read_yaw_rate()
 Arguments		:	none
 Return Value	:	Raw angular velocity
 Example Call	:	read_gyro()
@@ -90,15 +337,43 @@ Example Call	:	read_gyro()
 float read_gyro()
 {
 	float yg_rate=0;
-	INT8 gyro_data[2] = {0, 0};
+	INT8 gyro_data[8] = {0, 0, 0, 0, 0, 0, 0, 0};
 	
-	// Read gyroscope data
-	check_status(i2c_read_multi_byte(L3G4200D_ADDRESS, L3G4200D_OUT_Y_L, 2, gyro_data));
+	// The FIFO holds the samples until the start-up calibration is done, use the latest
+	if (!gyro_bias.calibrated) calibrate_gyro();
+	else
+	{
+		// Read gyroscope data, OUT_TEMP to OUT_Z_H (STATUS_REG and the X-axis are in between)
+		check_status(i2c_read_multi_byte(L3G4200D_ADDRESS, L3G4200D_OUT_TEMP, 8, gyro_data));
+		
+		// Combine low and high bytes
+		gyro_bias.raw[0] = (UINT8)gyro_data[4] | (UINT8)gyro_data[5]<<8;
+		gyro_bias.raw[1] = (UINT8)gyro_data[6] | (UINT8)gyro_data[7]<<8;
+		
+		// The bias is interpolated again only when the temperature changes (1 deg C steps)
+		if (-gyro_data[0] != gyro_temp.temperature) compensate_gyro_temp(-gyro_data[0]);
+	}
 	
-	// Combine low and high bytes
-	yg_rate = convert_gyro(((UINT8)gyro_data[0] | (UINT8)gyro_data[1]<<8), y_offset);
+	// Temperature bias removed with the conversion
+	yg_rate = convert_gyro(gyro_bias.raw[0], gyro_temp.bias[0]);
+	yaw_rate = convert_gyro(gyro_bias.raw[1], gyro_temp.bias[1]);
+	update_gyro_bias(yg_rate, yaw_rate);
 	
-	return yg_rate;
+	// Remove the offsets
+	yaw_rate -= gyro_bias.offset[1];
+	return (yg_rate - gyro_bias.offset[0]);
+}
+
+/**********************************
+Function name	:	read_yaw_rate
+Functionality	:	Returns the Z-axis angular velocity from the latest read_gyro()
+Arguments		:	none
+Return Value	:	Yaw rate in DPS
+Example Call	:	read_yaw_rate()
+***********************************/
+float read_yaw_rate()
+{
+	return yaw_rate;
 }
 
 /**********************************
@@ -14,14 +14,82 @@
 #ifndef GYRO_H_
 #define GYRO_H_
 
+// Uncomment to record the bias against the temperature into the EEPROM table. Leave the
+// robot still from a cold start while the board warms up, each point is saved when measured
+//#define GYRO_TEMP_CALIBRATE
+
 // Register Map
 #define L3G4200D_ADDRESS		0x69 << 1
 #define L3G4200D_WHO_AM_I		0x0F
 #define L3G4200D_KNOWN_ID		0xD3
 #define L3G4200D_CTRL_REG1		0x20
 #define L3G4200D_CTRL_REG4		0x23
+#define L3G4200D_CTRL_REG5		0x24
+#define L3G4200D_OUT_TEMP		0x26
 #define L3G4200D_OUT_X_L		0x28
 #define L3G4200D_OUT_Y_L		0x2A
+#define L3G4200D_OUT_Z_L		0x2C
+#define L3G4200D_FIFO_CTRL_REG	0x2E
+#define L3G4200D_FIFO_SRC_REG	0x2F
+
+// Offsets measured on the robot, kept if the start-up calibration times out
+#define GYRO_Y_OFFSET			0.93170		// (DPS)
+#define GYRO_Z_OFFSET			0.28436
+
+// Start-up calibration, the FIFO is read in bursts at 800Hz from the Timer 3 ISR
+#define GYRO_BURST				8			// Samples per burst (6 bytes each), the FIFO holds 32
+#define GYRO_SETTLE_SAMPLES		32			// Discarded after the rate change
+#define GYRO_CALIBRATION_SAMPLES	800		// Averaged while still (1s)
+#define GYRO_CALIBRATION_TIMEOUT	2400	// Samples before the measured offsets are kept (3s)
+#define GYRO_STILL_SPREAD		43			// Largest spread of a still burst (LSB, 3 DPS)
+
+// Online bias estimate, while both rates stay near their offsets
+#define GYRO_STILL_RATE			1.5			// Largest rate of a still sample (DPS)
+#define GYRO_STILL_SAMPLES		50			// Still samples before the update starts (0.5s)
+#define GYRO_BIAS_GAIN			0.002		// Update per still sample (5s time constant)
+
+// Structure to hold the gyroscope bias estimate
+typedef struct GyroBias
+{
+	float offset[2];			// Y (pitch) and Z (yaw) rate offsets (DPS)
+	long sum[2];				// Raw sums of the start-up average
+	UINT16 raw[2];				// Latest raw Y and Z sample
+	unsigned int samples;		// Samples in the start-up average
+	unsigned int total;			// Samples read from the FIFO
+	unsigned int still;			// Consecutive still samples
+	bool calibrated;			// Start-up calibration done or timed out
+};
+
+// Temperature compensation, the sensor temperature has no fixed offset so the points
+// are counted from the temperature at the start of the table calibration
+#define GYRO_TEMP_MAGIC			0xB5		// Marks a recorded table in the EEPROM
+#define GYRO_TEMP_POINTS		8
+#define GYRO_TEMP_STEP			4			// Between points (deg C)
+#define GYRO_TEMP_SAMPLES		1000		// Still samples averaged per point (10s)
+
+// Bias against temperature, as kept in the EEPROM
+typedef struct GyroTempTable
+{
+	unsigned char magic;
+	signed char base;						// Temperature of the first point (deg C)
+	unsigned char valid;					// Bit mask of the recorded points
+	int bias[GYRO_TEMP_POINTS][2];			// Y and Z bias (0.001 DPS)
+};
+
+// Structure to hold the temperature compensation and the table calibration
+typedef struct GyroTemp
+{
+	GyroTempTable table;
+	int temperature;			// Latest reading (deg C)
+	float bias[2];				// Y and Z bias at that temperature (DPS)
+	float sum[2];				// Still rates of the point being recorded
+	unsigned int samples;
+	int point;
+	bool dirty;					// Table to be saved
+};
+
+extern GyroBias gyro_bias;
+extern GyroTemp gyro_temp;
 
 
 // Function Declarations
@@ -46,13 +114,23 @@ float convert_gyro(UINT16 value, float offset);
 
 /**********************************
 Function name	:	read_gyro
-Functionality	:	To read Y-axis angular velocity from Gyroscope
+Functionality	:	To read Y-axis angular velocity from Gyroscope, Z-axis (yaw) rate is
+					read in the same burst and stored for read_yaw_rate()
 Arguments		:	none
 Return Value	:	Raw angular velocity
 Example Call	:	read_gyro()
 ***********************************/
 float read_gyro();
 
+/**********************************
+Function name	:	read_yaw_rate
+Functionality	:	Returns the Z-axis angular velocity from the latest read_gyro()
+Arguments		:	none
+Return Value	:	Yaw rate in DPS
+Example Call	:	read_yaw_rate()
+***********************************/
+float read_yaw_rate();
+
 /**********************************
 Function name	:	get_gyro_angle
 Functionality	:	Computes the angular position by integrating angular velocity
@@ -62,13 +140,73 @@ Example Call	:	get_gyro_angle(epoch(), tilt_angle)
 ***********************************/
 float get_gyro_angle(unsigned long current_time, float pitch_angle);
 
+/**********************************
+Function name	:	read_gyro_temp
+Functionality	:	To read the temperature of the gyroscope on its own
+Arguments		:	none
+Return Value	:	Temperature (deg C, no fixed offset)
+Example Call	:	read_gyro_temp()
+***********************************/
+int read_gyro_temp();
+
+/**********************************
+Function name	:	compensate_gyro_temp
+Functionality	:	Interpolates the Y and Z bias at a temperature between the recorded
+					points of the table, the end points are held beyond it
+Arguments		:	Temperature (deg C)
+Return Value	:	void
+Example Call	:	compensate_gyro_temp(read_gyro_temp())
+***********************************/
+void compensate_gyro_temp(int temperature);
+
+/**********************************
+Function name	:	record_gyro_temp
+Functionality	:	Averages still rates into the nearest point of the table, the point is
+					stored after GYRO_TEMP_SAMPLES and the table marked to be saved
+Arguments		:	Y and Z angular velocity without any offset removed (DPS)
+Return Value	:	void
+Example Call	:	record_gyro_temp(y_rate, z_rate)
+***********************************/
+void record_gyro_temp(float y_rate, float z_rate);
+
+/**********************************
+Function name	:	save_gyro_temp
+Functionality	:	Writes the table to the EEPROM if a point was recorded. Blocks for 3.4ms
+					per changed byte, call it from the telemetry task
+Arguments		:	none
+Return Value	:	void
+Example Call	:	save_gyro_temp()
+***********************************/
+void save_gyro_temp();
+
 /**********************************
 Function name	:	calibrate_gyro
-Functionality	:	Reads values of Gyroscope when static, computes average offset
+Functionality	:	Reads a burst of the FIFO and averages it into the offsets while the
+					robot is still, a movement restarts the average. Switches the gyroscope
+					back to 100Hz without the FIFO when done
 Arguments		:	None
 Return Value	:	void
 Example Call	:	calibrate_gyro()
 ***********************************/
-//void calibrate_gyro();
+void calibrate_gyro();
+
+/**********************************
+Function name	:	update_gyro_bias
+Functionality	:	Refines the offsets with a slow filter once both rates have stayed
+					near them for GYRO_STILL_SAMPLES, tracks the drift as the sensor warms
+Arguments		:	Y and Z angular velocity without the offsets removed (DPS)
+Return Value	:	void
+Example Call	:	update_gyro_bias(y_rate, z_rate)
+***********************************/
+void update_gyro_bias(float y_rate, float z_rate);
+
+/**********************************
+Function name	:	gyro_calibrated
+Functionality	:	Returns true once the start-up calibration is done or has timed out
+Arguments		:	none
+Return Value	:	Calibration state
+Example Call	:	gyro_calibrated()
+***********************************/
+bool gyro_calibrated();
 
 #endif
\ No newline at end of file
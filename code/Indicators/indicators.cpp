@@ -11,8 +11,9 @@
 * Library for LED status indicators and buzzer tones
 */
 
-#include <Arduino.h>
-#include "../Tones/anyrtttl.h"
+#include "../Support/platform.h"
+#include "../Tones/rtttl_compiler.h"
+#include "../Tones/player.h"
 #include "../Support/digitalWriteFast.h"
 #include "../Timers/timers.h"
 #include "indicators.h"
@@ -23,6 +24,7 @@ bool INITIAL_FLAG = true;
 bool READY_FLAG = false;
 bool BUZZER_SONG = true;
 bool ERROR_STATE = false;
+bool READY_STATE = false;
 
 // LED indicator flags
 bool LEFT_INDICATOR = false;
@@ -31,20 +33,39 @@ bool STOP_INDICATOR = true;
 bool FRONT_INDICATOR = false;
 bool BACK_INDICATOR = false;
 bool SLOPE_INDICATOR = false;
+bool BATTERY_INDICATOR = false;
+
+// LED patterns: (duration, LED bitmask) steps, a zero duration repeats the pattern
+const LedStep pattern_initial[] PROGMEM = {{1000, BOTH_RED}, {0, 0}};
+const LedStep pattern_ready[] PROGMEM   = {{1000, BOTH_GRN}, {0, 0}};
+const LedStep pattern_buzzer[] PROGMEM  = {{1000, BOTH_WHITE}, {0, 0}};
+const LedStep pattern_error[] PROGMEM   = {{1000, BOTH_RED}, {0, 0}};
+const LedStep pattern_stop[] PROGMEM    = {{50, BOTH_RED}, {50, LED_OFF}, {50, BOTH_RED}, {850, LED_OFF}, {0, 0}};
+const LedStep pattern_front[] PROGMEM   = {{100, BOTH_GRN}, {150, LED_OFF}, {0, 0}};
+const LedStep pattern_back[] PROGMEM    = {{100, BOTH_GRN | BOTH_BLU}, {150, LED_OFF}, {0, 0}};
+const LedStep pattern_left[] PROGMEM    = {{100, ALPHA_RED | ALPHA_GRN}, {100, LED_OFF}, {0, 0}};
+const LedStep pattern_right[] PROGMEM   = {{100, BETA_RED | BETA_GRN}, {100, LED_OFF}, {0, 0}};
+const LedStep pattern_slope[] PROGMEM   = {{150, BOTH_BLU}, {150, LED_OFF}, {0, 0}};
+const LedStep pattern_battery[] PROGMEM = {{500, LED_OFF}, {100, BOTH_RED | BOTH_BLU}, {1400, LED_OFF}, {0, 0}};
+const LedStep pattern_beacon[] PROGMEM  = {{200, LED_OFF}, {60, BOTTOM_ON}, {740, LED_OFF}, {0, 0}};
+
+// LED pattern players
+LedPattern status_leds = {NULL, 0, 0, 0};
+LedPattern battery_leds = {NULL, 0, 0, 0};
+LedPattern beacon_leds = {NULL, 0, 0, 0};
+unsigned char led_output = 0xFF;
 
 // Timing variables
 unsigned long buzz_time = 0;
 unsigned long error_time = 0;
-unsigned long led_bottom_time = 0;
-unsigned long alpha_time = 0;
-unsigned long beta_time = 0;
+unsigned long ready_time = 0;
 
-// RTTTL tones
-const char * song_startup = "Startup:d=8,o=6,b=200:8c.6,8c.7,8g.6,8f6,4e.6,16f6,16g6,4c.7";
-const char * song_ready = "Ready:d=8,o=6,b=180:16e6,16f6,16g6,8c.7";
-const char * song_buzzer = "Buzzer:d=8,o=6,b=200:8g6,8e6,8c6,8f6,8c7,4g.6,16f6,16g6,4c.7";
-const char * song_buzzer2 = "Buzzer2:d=16,o=7,b=95:32d,32d#,32d,32d#,32d,32d#,32d,32d#,32d,32d,32d#,32e,32f,32f#,32g,g";
-const char * song_mission = "MissionImp:d=16,o=7,b=95:g,8p,g,8p,a#,p,c7,p,g,8p,g,8p,f,p,f#,p,g,8p,g,8p,a#,p,c7,p,g,8p,g,8p,f,p,f#,p,a#,g,2d,32p,a#,g,2c#,32p,a#,g,2c,a#5,8c,2p,32p,a#5,g5,2f#,32p,a#5,g5,2f,32p,a#5,g5,2e,d#,8d";
+// RTTTL tones, compiled to packed notes in flash
+RTTTL_SONG(song_startup, "Startup:d=8,o=6,b=200:8c.6,8c.7,8g.6,8f6,4e.6,16f6,16g6,4c.7");
+RTTTL_SONG(song_ready, "Ready:d=8,o=6,b=180:16e6,16f6,16g6,8c.7");
+RTTTL_SONG(song_buzzer, "Buzzer:d=8,o=6,b=200:8g6,8e6,8c6,8f6,8c7,4g.6,16f6,16g6,4c.7");
+RTTTL_SONG(song_buzzer2, "Buzzer2:d=16,o=7,b=95:32d,32d#,32d,32d#,32d,32d#,32d,32d#,32d,32d,32d#,32e,32f,32f#,32g,g");
+RTTTL_SONG(song_mission, "MissionImp:d=16,o=7,b=95:g,8p,g,8p,a#,p,c7,p,g,8p,g,8p,f,p,f#,p,g,8p,g,8p,a#,p,c7,p,g,8p,g,8p,f,p,f#,p,a#,g,2d,32p,a#,g,2c#,32p,a#,g,2c,a#5,8c,2p,32p,a#5,g5,2f#,32p,a#5,g5,2f,32p,a#5,g5,2e,d#,8d");
 
 /**********************************
 Function name	:	led_pin_config
@@ -118,22 +139,74 @@ void led_indicator_master(bool state)
 }
 
 /**********************************
-Function name	:	blinker
-Functionality	:	Non-blocking periodic LED blinker
-Arguments		:	LED pin number, On time instant, Off time instant, Time period, 
-					Power hardware control, Power software control
+Function name	:	led_pattern_update
+Functionality	:	To advance a LED pattern player, steps are only read from flash
+					when the deadline of the current step has passed
+Arguments		:	Pattern player, Pattern steps (NULL for off), Current time
+Return Value	:	LED bitmask of the current step
+Example Call	:	led_pattern_update(&status_leds, pattern_stop, epoch())
+***********************************/
+unsigned char led_pattern_update(LedPattern *pattern, const LedStep *steps, unsigned long now)
+{
+	unsigned int duration=0;
+	
+	// Restart when the indicator state changes
+	if (pattern->steps != steps)
+	{
+		pattern->steps = steps;
+		pattern->index = 0;
+		pattern->deadline = now;
+		pattern->leds = LED_OFF;
+		if (steps == NULL) return LED_OFF;
+		
+		pattern->leds = pgm_read_byte(&steps[0].leds);
+		pattern->deadline += pgm_read_word(&steps[0].duration);
+	}
+	if (steps == NULL) return LED_OFF;
+	
+	// Move to the next step, a zero duration marks the end of the pattern
+	while ((long)(now - pattern->deadline) >= 0)
+	{
+		duration = pgm_read_word(&steps[++pattern->index].duration);
+		if (duration == 0)
+		{
+			pattern->index = 0;
+			duration = pgm_read_word(&steps[0].duration);
+		}
+		
+		pattern->leds = pgm_read_byte(&steps[pattern->index].leds);
+		pattern->deadline += duration;
+	}
+	
+	return pattern->leds;
+}
+
+/**********************************
+Function name	:	write_leds
+Functionality	:	To write a LED bitmask with one masked write per LED port
+Arguments		:	LED bitmask
 Return Value	:	None
-Example Call	:	blinker
+Example Call	:	write_leds(BOTH_RED | BOTTOM_ON)
 ***********************************/
-void blinker(uint8_t pin, int on_time, int off_time, int period, bool dir, bool power)
+void write_leds(unsigned char leds)
 {
-	// Software power control
-	if (!power) return;
-	unsigned long time_now = epoch();
+	unsigned char alpha=0, beta=0, bottom=0;
+	unsigned char sreg = SREG;
 	
-	// Non-blocking blinker [Beacon Lights]
-	if (((time_now % period)>=on_time) && ((time_now % period)<=(on_time+6))) digitalWriteFast(pin, dir);
-	if (((time_now % period)>=off_time) && ((time_now % period)<=(off_time+6))) digitalWriteFast(pin, !dir);
+	// RGB LEDs are active low
+	if (!(leds & ALPHA_RED)) alpha |= LED1_RED_BIT;
+	if (!(leds & ALPHA_GRN)) alpha |= LED1_GRN_BIT;
+	if (!(leds & ALPHA_BLU)) alpha |= LED1_BLU_BIT;
+	if (!(leds & BETA_RED))  beta |= LED2_RED_BIT;
+	if (!(leds & BETA_GRN))  beta |= LED2_GRN_BIT;
+	if (!(leds & BETA_BLU))  beta |= LED2_BLU_BIT;
+	if (leds & BOTTOM_ON)    bottom = LED_BOTTOM_BIT;
+	
+	cli();
+	LED1_PORT = (LED1_PORT & ~LED1_MASK) | alpha;
+	LED2_PORT = (LED2_PORT & ~LED2_MASK) | beta;
+	LED_BOTTOM_PORT = (LED_BOTTOM_PORT & ~LED_BOTTOM_BIT) | bottom;
+	SREG = sreg;
 }
 
 /**********************************
@@ -145,73 +218,34 @@ Example Call	:	led_scheduler()
 ***********************************/
 void led_scheduler()
 {
-	// Bottom LED - Robot setup time
-	blinker(LED_BOTTOM, 200, 260, 1000, true, true);
+	unsigned long now = epoch();
+	const LedStep *status = NULL;
+	unsigned char leds = 0;
 	
-	// Initial LED status
-	if (epoch() < 3000)
-	{
-		alpha_red(true);
-		beta_red(true);
-		return;
-	}
+	// Highest priority indicator state
+	if (!READY_STATE) status = pattern_initial;				// Initial LED status
+	else if ((now - ready_time) < READY_LED_TIME) status = pattern_ready;	// Robot ready - Green
+	else if (BUZZER_STATE) status = pattern_buzzer;			// Buzzer - White
+	else if (ERROR_STATE) status = pattern_error;			// Error - Red
+	else if (STOP_INDICATOR) status = pattern_stop;			// Stop - Red
+	else if (FRONT_INDICATOR) status = pattern_front;		// Forward - Green
+	else if (BACK_INDICATOR) status = pattern_back;			// Back - Cyan
+	else if (LEFT_INDICATOR) status = pattern_left;			// Left - Yellow
+	else if (RIGHT_INDICATOR) status = pattern_right;		// Right - Yellow
+	else if (SLOPE_INDICATOR) status = pattern_slope;		// Slope Mode - Blue
 	
-	// Initial LED - Robot ready
-	if ((epoch()>=3000) && (epoch()<3500))
-	{
-		alpha_red(false);	beta_red(false);
-		alpha_green(true);	beta_green(true);
-		return;
-	}
+	leds = led_pattern_update(&status_leds, status, now);
+	leds |= led_pattern_update(&beacon_leds, pattern_beacon, now);	// Bottom LED - Robot setup time
 	
-	// Buzzer - White
-	if (BUZZER_STATE)
-	{
-		led_indicator_master(true);
-		return;
-	}
+	// Low Battery - Magenta, clear of the stop blink
+	if (READY_STATE && ((now - ready_time) >= READY_LED_TIME)) leds |= led_pattern_update(&battery_leds, BATTERY_INDICATOR ? pattern_battery : NULL, now);
 	
-	// Error Indicator - Red
-	if (ERROR_STATE)
+	// Only touch the ports when an LED changes
+	if (leds != led_output)
 	{
-		led_indicator_master(false);
-		alpha_red(true);
-		beta_red(true);
-		return;
+		led_output = leds;
+		write_leds(leds);
 	}
-	
-	// Turn off all LEDs
-	led_indicator_master(false);
-	
-	// Blinker Logic
-	
-	// Stop - Red
-	blinker(LED1_RED, 0, 50, 1000, false, STOP_INDICATOR);
-	blinker(LED2_RED, 0, 50, 1000, false, STOP_INDICATOR);
-	blinker(LED1_RED, 100, 150, 1000, false, STOP_INDICATOR);
-	blinker(LED2_RED, 100, 150, 1000, false, STOP_INDICATOR);
-	
-	// Forward - Green
-	blinker(LED1_GRN, 0, 100, 250, false, FRONT_INDICATOR);
-	blinker(LED2_GRN, 0, 100, 250, false, FRONT_INDICATOR);
-	
-	// Back - Cyan
-	blinker(LED1_GRN, 0, 100, 250, false, BACK_INDICATOR);
-	blinker(LED1_BLU, 0, 100, 250, false, BACK_INDICATOR);
-	blinker(LED2_GRN, 0, 100, 250, false, BACK_INDICATOR);
-	blinker(LED2_BLU, 0, 100, 250, false, BACK_INDICATOR);
-	
-	// Left - Yellow
-	blinker(LED1_RED, 0, 100, 200, false, LEFT_INDICATOR);
-	blinker(LED1_GRN, 0, 100, 200, false, LEFT_INDICATOR);
-	
-	// Right - Yellow
-	blinker(LED2_RED, 0, 100, 200, false, RIGHT_INDICATOR);
-	blinker(LED2_GRN, 0, 100, 200, false, RIGHT_INDICATOR);
-	
-	// Slope Mode - Blue
-	blinker(LED1_BLU, 0, 150, 300, false, SLOPE_INDICATOR);
-	blinker(LED2_BLU, 0, 150, 300, false, SLOPE_INDICATOR);
 }
 
 /**********************************
@@ -251,20 +285,33 @@ void set_error_state(bool state) {ERROR_STATE = state;}
 bool read_error_state() {return ERROR_STATE;}
 void set_error_time() {error_time = epoch();}
 
+void set_battery_state(bool state) {BATTERY_INDICATOR = state;}
+
+void set_ready_state(bool state)
+{
+	if (state && !READY_STATE) ready_time = epoch();
+	READY_STATE = state;
+}
+bool read_ready_state() {return READY_STATE;}
+
+// The ready tone would cut the start-up tone short, so the robot is ready once it has ended
+bool startup_tone_done() {return !INITIAL_FLAG && !player_playing();}
+
 /**********************************
 Function name	:	play_music
-Functionality	:	Play non-blocking RTTTL tone
+Functionality	:	Play RTTTL tone in the background, notes are advanced by the
+					Timer 4 compare interrupt and the tone is generated by Timer 2
 Arguments		:	Song number
 Return Value	:	None
 Example Call	:	play_music(2)
 ***********************************/
 void play_music(int song)
 {
-	if (song==1)	  anyrtttl::nonblocking::begin(BUZZER_PIN, song_startup);
-	else if (song==2) anyrtttl::nonblocking::begin(BUZZER_PIN, song_ready);
-	else if (song==3) anyrtttl::nonblocking::begin(BUZZER_PIN, song_buzzer);
-	else if (song==4) anyrtttl::nonblocking::begin(BUZZER_PIN, song_buzzer2);
-	else if (song==5) anyrtttl::nonblocking::begin(BUZZER_PIN, song_mission);
+	if (song==1)	  player_begin(song_startup.words);
+	else if (song==2) player_begin(song_ready.words);
+	else if (song==3) player_begin(song_buzzer.words);
+	else if (song==4) player_begin(song_buzzer2.words);
+	else if (song==5) player_begin(song_mission.words);
 }
 
 /**********************************
@@ -309,7 +356,7 @@ void initial_buzz()
 	}
 	
 	// Initial ready tone
-	if (READY_FLAG && (epoch()>3000))
+	if (READY_FLAG && READY_STATE)
 	{
 		play_music(2);
 		READY_FLAG = false;
@@ -317,14 +364,13 @@ void initial_buzz()
 }
 
 /**********************************
-Function name	:
-Functionality	:
+Function name	:	buzz_scheduler
+Functionality	:	To run the buzzer tasks, songs play from the player interrupt
 Arguments		:	None
 Return Value	:	None
-Example Call	:
+Example Call	:	buzz_scheduler()
 ***********************************/
 void buzz_scheduler()
 {
 	initial_buzz();
-	if ((epoch()<5000) || BUZZER_STATE) anyrtttl::nonblocking::play();
 }
\ No newline at end of file
@@ -26,6 +26,55 @@
 #define LED2_GRN	33
 #define LED2_BLU	35
 
+// LED Port Mapping (must match the pin numbers above)
+#define LED1_PORT		PORTK
+#define LED1_RED_BIT	0x40		// PK6 - A14
+#define LED1_GRN_BIT	0x04		// PK2 - A10
+#define LED1_BLU_BIT	0x10		// PK4 - A12
+#define LED1_MASK		0x54
+
+#define LED2_PORT		PORTC
+#define LED2_RED_BIT	0x40		// PC6 - 31
+#define LED2_GRN_BIT	0x10		// PC4 - 33
+#define LED2_BLU_BIT	0x04		// PC2 - 35
+#define LED2_MASK		0x54
+
+#define LED_BOTTOM_PORT	PORTF
+#define LED_BOTTOM_BIT	0x80		// PF7 - A7
+
+// LED Pattern Bitmask
+#define LED_OFF			0x00
+#define ALPHA_RED		0x01
+#define ALPHA_GRN		0x02
+#define ALPHA_BLU		0x04
+#define BETA_RED		0x08
+#define BETA_GRN		0x10
+#define BETA_BLU		0x20
+#define BOTTOM_ON		0x40
+#define BOTH_RED		(ALPHA_RED | BETA_RED)
+#define BOTH_GRN		(ALPHA_GRN | BETA_GRN)
+#define BOTH_BLU		(ALPHA_BLU | BETA_BLU)
+#define BOTH_WHITE		(BOTH_RED | BOTH_GRN | BOTH_BLU)
+
+// Start-up
+#define READY_LED_TIME	500			// Green ready LEDs (ms)
+
+// One step of a LED pattern
+typedef struct LedStep
+{
+	unsigned int duration;		// Step duration (ms), 0 marks the end of the pattern
+	unsigned char leds;			// LED bitmask
+};
+
+// Structure to hold the state of a LED pattern player
+typedef struct LedPattern
+{
+	const LedStep *steps;		// Pattern in flash
+	unsigned char index;		// Current step
+	unsigned long deadline;		// End of the current step (ms)
+	unsigned char leds;			// LED bitmask of the current step
+};
+
 // Function Declarations
 void led_pin_config();
 
@@ -39,7 +88,8 @@ void beta_blue(bool state);
 
 void set_led_indicators(bool stopped, bool front, bool reverse, bool left, bool right, bool err);
 void led_indicator_master(bool state);
-void blinker(uint8_t pin, int on_time, int off_time, int period, bool dir, bool power);
+unsigned char led_pattern_update(LedPattern *pattern, const LedStep *steps, unsigned long now);
+void write_leds(unsigned char leds);
 void led_scheduler();
 
 void buzzer_pin_config();
@@ -51,6 +101,10 @@ void set_buzz_time();
 void set_error_state(bool state);
 bool read_error_state();
 void set_error_time();
+void set_battery_state(bool state);
+void set_ready_state(bool state);
+bool read_ready_state();
+bool startup_tone_done();
 void play_music(int song);
 void initial_buzz();
 void buzz_scheduler();
@@ -0,0 +1,206 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: mag.cpp
+*
+* Created: 19-Oct-26 4:14:35 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for HMC5883L Magnetometer
+*
+* Functions: mag_init(), mag_start_read(), mag_busy(), mag_abort(), ISR(TWI_vect),
+* read_mag_heading(), mag_calibrate()
+* Global Variables: mag
+*/
+
+#include <math.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "../I2C/i2c_lib.h"
+#include "../Support/support_lib.h"
+#include "mag.h"
+
+// TWCR values for the asynchronous read
+#define TWI_START		(done | start | i2cen | 0x01)
+#define TWI_NEXT		(done | i2cen | 0x01)
+#define TWI_ACK			(done | eack | i2cen | 0x01)
+#define TWI_STOP		(done | stop | i2cen)
+
+// Structure Initialization
+Magnetometer mag = {MAG_IDLE, 0, {0, 0, 0, 0, 0, 0}, false, 0,
+					{MAG_OFFSET_X, MAG_OFFSET_Y, MAG_OFFSET_Z}, {MAG_SCALE_X, MAG_SCALE_Y, MAG_SCALE_Z},
+					{32767, 32767, 32767}, {-32768, -32768, -32768}};
+
+/**********************************
+Function name	:	mag_init
+Functionality	:	Initialize the magnetometer in continuous measurement mode
+Arguments		:	none
+Return Value	:	void
+Example Call	:	mag_init()
+***********************************/
+void mag_init()
+{
+	check_device_ID(HMC5883L_ADDRESS, HMC5883L_ID_A, HMC5883L_KNOWN_ID);			// Verify Device ID
+	check_status(i2c_sendbyte(HMC5883L_ADDRESS, HMC5883L_CONFIG_A, 0x78));		// 8 sample average, 75Hz
+	check_status(i2c_sendbyte(HMC5883L_ADDRESS, HMC5883L_CONFIG_B, 0x20));		// 1.3Ga, 1090 LSB/Ga
+	check_status(i2c_sendbyte(HMC5883L_ADDRESS, HMC5883L_MODE, 0x00));			// Continuous measurement
+}
+
+/**********************************
+Function name	:	mag_start_read
+Functionality	:	To start an interrupt driven burst read of the output registers,
+					a read still in progress is aborted first
+Arguments		:	none
+Return Value	:	void
+Example Call	:	mag_start_read()
+***********************************/
+void mag_start_read()
+{
+	if (mag_busy()) mag_abort();
+	
+	mag.index = 0;
+	mag.state = MAG_WRITE;
+	TWCR = TWI_START;
+}
+
+/**********************************
+Function name	:	mag_abort
+Functionality	:	To release the bus from an unfinished asynchronous read
+Arguments		:	none
+Return Value	:	void
+Example Call	:	mag_abort()
+***********************************/
+void mag_abort()
+{
+	TWCR = TWI_STOP;
+	mag.state = MAG_IDLE;
+	mag.errors++;
+}
+
+/**********************************
+Function name	:	ISR(TWI_vect)
+Functionality	:	ISR for the TWI, runs the asynchronous read one bus event at a time
+Arguments		:	TWI vector
+Return Value	:	None
+Example Call	:	Called automatically
+***********************************/
+ISR(TWI_vect)
+{
+	switch (TWSR & 0xF8)
+	{
+		// Start, Repeated start
+		case 0x08:
+		case 0x10:
+			TWDR = HMC5883L_ADDRESS | ((mag.state == MAG_READ) ? i2read : i2write);
+			TWCR = TWI_NEXT;
+		break;
+		
+		// SLA+W acknowledged, the register pointer auto increments
+		case 0x18:
+			TWDR = HMC5883L_OUT_X_H;
+			TWCR = TWI_NEXT;
+		break;
+		
+		// Register address sent
+		case 0x28:
+			mag.state = MAG_READ;
+			TWCR = TWI_START;
+		break;
+		
+		// SLA+R acknowledged
+		case 0x40:
+			TWCR = TWI_ACK;
+		break;
+		
+		// Data received, NACK the last byte
+		case 0x50:
+			mag.data[mag.index++] = TWDR;
+			TWCR = (mag.index < 5) ? TWI_ACK : TWI_NEXT;
+		break;
+		
+		// Last byte received
+		case 0x58:
+			mag.data[mag.index++] = TWDR;
+			TWCR = TWI_STOP;
+			mag.state = MAG_IDLE;
+			mag.ready = true;
+		break;
+		
+		default:
+			mag_abort();
+		break;
+	}
+}
+
+/**********************************
+Function name	:	read_mag_heading
+Functionality	:	To compute the tilt compensated heading from a new calibrated sample
+Arguments		:	Pitch angle (degrees), Pointer to store the heading
+Return Value	:	True if a new sample was available
+Example Call	:	read_mag_heading(tilt_angle, &heading)
+***********************************/
+bool read_mag_heading(float pitch_angle, float *heading)
+{
+	INT16 raw[3];
+	float field[3], horizontal_x=0, pitch=0;
+	
+	if (!mag.ready) return false;
+	mag.ready = false;
+	
+	// Registers are X, Z, Y
+	raw[0] = (INT16)((mag.data[0] << 8) | mag.data[1]);
+	raw[2] = (INT16)((mag.data[2] << 8) | mag.data[3]);
+	raw[1] = (INT16)((mag.data[4] << 8) | mag.data[5]);
+	
+	// -4096 is reported on ADC overflow
+	if ((raw[0] == -4096) || (raw[1] == -4096) || (raw[2] == -4096)) return false;
+	
+	for (int i=0; i<3; i++)
+	{
+		// Record the extremes for calibration
+		if (raw[i] < mag.minimum[i]) mag.minimum[i] = raw[i];
+		if (raw[i] > mag.maximum[i]) mag.maximum[i] = raw[i];
+		
+		// Remove hard iron offset and soft iron scaling
+		field[i] = (raw[i] - mag.offset[i])*mag.scale[i];
+	}
+	
+	// Project on to the horizontal plane, the robot pitches about the Y-axis
+	pitch = pitch_angle*(M_PI/180.0);
+	horizontal_x = field[0]*cos(pitch) + field[2]*sin(pitch);
+	
+	// Counter-clockwise positive heading, same sense as the gyroscope Z-axis
+	*heading = atan2(-field[1], horizontal_x)*(180.0/M_PI);
+	return true;
+}
+
+/**********************************
+Function name	:	mag_calibrate
+Functionality	:	To compute the hard and soft iron calibration of the X and Y axes from the extremes
+					recorded since start-up
+Arguments		:	none
+Return Value	:	void
+Example Call	:	mag_calibrate()
+***********************************/
+void mag_calibrate()
+{
+	float radius[2], average=0;
+	
+	// Turning on the ground only spans the X and Y axes, Z keeps its defaults
+	for (int i=0; i<2; i++)
+	{
+		if (mag.maximum[i] <= mag.minimum[i]) return;
+		
+		mag.offset[i] = (mag.maximum[i] + mag.minimum[i])/2.0;
+		radius[i] = (mag.maximum[i] - mag.minimum[i])/2.0;
+		average += radius[i]/2.0;
+	}
+	
+	// Scale the ellipse axes to a circle
+	for (int i=0; i<2; i++) mag.scale[i] = average/radius[i];
+}
+
+// Getter function
+bool mag_busy() {return (mag.state != MAG_IDLE);}
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: mag.h
+*
+* Created: 19-Oct-26 4:14:35 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for HMC5883L Magnetometer
+*/
+
+#ifndef MAG_H_
+#define MAG_H_
+
+// Register Map
+#define HMC5883L_ADDRESS		0x1E << 1
+#define HMC5883L_CONFIG_A		0x00
+#define HMC5883L_CONFIG_B		0x01
+#define HMC5883L_MODE			0x02
+#define HMC5883L_OUT_X_H		0x03		// X, Z, Y output registers, MSB first
+#define HMC5883L_ID_A			0x0A
+#define HMC5883L_KNOWN_ID		0x48		// 'H'
+
+// Uncomment to calibrate while the robot is turned through full circles after start-up
+// The result is used immediately and sent as telemetry to be copied into the defaults below
+//#define MAG_CALIBRATE
+#define MAG_CALIBRATION_TIME	20000		// Calibration window (ms)
+
+// Hard iron offsets (raw counts) and soft iron scale factors
+#define MAG_OFFSET_X			0
+#define MAG_OFFSET_Y			0
+#define MAG_OFFSET_Z			0
+#define MAG_SCALE_X				1.0
+#define MAG_SCALE_Y				1.0
+#define MAG_SCALE_Z				1.0
+
+// Asynchronous Read States
+#define MAG_IDLE				0
+#define MAG_WRITE				1			// Register address phase
+#define MAG_READ				2			// Data phase after the repeated start
+
+// Structure to hold the magnetometer state and calibration
+typedef struct Magnetometer
+{
+	volatile unsigned char state;		// Asynchronous read state
+	volatile unsigned char index;		// Number of data bytes received
+	volatile UINT8 data[6];				// Raw output registers
+	volatile bool ready;				// New sample available
+	volatile unsigned int errors;		// Failed or aborted reads
+	
+	float offset[3];					// Hard iron offsets (X, Y, Z)
+	float scale[3];						// Soft iron scale factors (X, Y, Z)
+	INT16 minimum[3];					// Calibration extremes
+	INT16 maximum[3];
+};
+
+extern Magnetometer mag;
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	mag_init
+Functionality	:	Initialize the magnetometer in continuous measurement mode
+Arguments		:	none
+Return Value	:	void
+Example Call	:	mag_init()
+***********************************/
+void mag_init();
+
+/**********************************
+Function name	:	mag_start_read
+Functionality	:	To start an interrupt driven burst read of the output registers,
+					a read still in progress is aborted first
+Arguments		:	none
+Return Value	:	void
+Example Call	:	mag_start_read()
+***********************************/
+void mag_start_read();
+
+/**********************************
+Function name	:	mag_busy
+Functionality	:	Returns the state of the asynchronous read
+Arguments		:	none
+Return Value	:	True while a read is in progress
+Example Call	:	mag_busy()
+***********************************/
+bool mag_busy();
+
+/**********************************
+Function name	:	mag_abort
+Functionality	:	To release the bus from an unfinished asynchronous read
+Arguments		:	none
+Return Value	:	void
+Example Call	:	mag_abort()
+***********************************/
+void mag_abort();
+
+/**********************************
+Function name	:	read_mag_heading
+Functionality	:	To compute the tilt compensated heading from a new calibrated sample
+Arguments		:	Pitch angle (degrees), Pointer to store the heading
+Return Value	:	True if a new sample was available
+Example Call	:	read_mag_heading(tilt_angle, &heading)
+***********************************/
+bool read_mag_heading(float pitch_angle, float *heading);
+
+/**********************************
+Function name	:	mag_calibrate
+Functionality	:	To compute the hard and soft iron calibration of the X and Y axes from the extremes
+					recorded since start-up
+Arguments		:	none
+Return Value	:	void
+Example Call	:	mag_calibrate()
+***********************************/
+void mag_calibrate();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: motor_lut.h
+*
+* Created: 19-Oct-26 4:08:40 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Inverse motor characteristic lookup tables
+* Index: |command| (0-255, linear in wheel speed), Value: Timer 5 duty (0-MOTOR_PWM_MAX)
+*
+* The default tables reproduce the previous linear map with minimum PWM 35 (left)
+* and 42 (right). Regenerate this file with Tools/motor_lut.cpp from the output
+* of characterise_motors() whenever the motors or gearboxes are changed.
+*/
+
+#ifndef MOTOR_LUT_H_
+#define MOTOR_LUT_H_
+
+#include <avr/pgmspace.h>
+
+// Left motor
+const unsigned int left_motor_lut[256] PROGMEM =
+{
+	  0,  51,  52,  54,  55,  56,  57,  59,  60,  61,  62,  64,  65,  66,  67,  69,
+	 70,  71,  72,  74,  75,  76,  77,  79,  80,  81,  82,  84,  85,  86,  87,  89,
+	 90,  91,  92,  94,  95,  96,  97,  99, 100, 101, 102, 104, 105, 106, 107, 109,
+	110, 111, 112, 114, 115, 116, 117, 118, 120, 121, 122, 123, 125, 126, 127, 128,
+	130, 131, 132, 133, 135, 136, 137, 138, 140, 141, 142, 143, 145, 146, 147, 148,
+	150, 151, 152, 153, 155, 156, 157, 158, 160, 161, 162, 163, 165, 166, 167, 168,
+	170, 171, 172, 173, 175, 176, 177, 178, 179, 181, 182, 183, 184, 186, 187, 188,
+	189, 191, 192, 193, 194, 196, 197, 198, 199, 201, 202, 203, 204, 206, 207, 208,
+	209, 211, 212, 213, 214, 216, 217, 218, 219, 221, 222, 223, 224, 226, 227, 228,
+	229, 231, 232, 233, 234, 236, 237, 238, 239, 241, 242, 243, 244, 245, 247, 248,
+	249, 250, 252, 253, 254, 255, 257, 258, 259, 260, 262, 263, 264, 265, 267, 268,
+	269, 270, 272, 273, 274, 275, 277, 278, 279, 280, 282, 283, 284, 285, 287, 288,
+	289, 290, 292, 293, 294, 295, 297, 298, 299, 300, 302, 303, 304, 305, 306, 308,
+	309, 310, 311, 313, 314, 315, 316, 318, 319, 320, 321, 323, 324, 325, 326, 328,
+	329, 330, 331, 333, 334, 335, 336, 338, 339, 340, 341, 343, 344, 345, 346, 348,
+	349, 350, 351, 353, 354, 355, 356, 358, 359, 360, 361, 363, 364, 365, 366, 368
+};
+
+// Right motor
+const unsigned int right_motor_lut[256] PROGMEM =
+{
+	  0,  61,  63,  64,  65,  66,  67,  69,  70,  71,  72,  73,  75,  76,  77,  78,
+	 79,  81,  82,  83,  84,  85,  87,  88,  89,  90,  91,  93,  94,  95,  96,  97,
+	 99, 100, 101, 102, 104, 105, 106, 107, 108, 110, 111, 112, 113, 114, 116, 117,
+	118, 119, 120, 122, 123, 124, 125, 126, 128, 129, 130, 131, 132, 134, 135, 136,
+	137, 138, 140, 141, 142, 143, 144, 146, 147, 148, 149, 151, 152, 153, 154, 155,
+	157, 158, 159, 160, 161, 163, 164, 165, 166, 167, 169, 170, 171, 172, 173, 175,
+	176, 177, 178, 179, 181, 182, 183, 184, 185, 187, 188, 189, 190, 192, 193, 194,
+	195, 196, 198, 199, 200, 201, 202, 204, 205, 206, 207, 208, 210, 211, 212, 213,
+	214, 216, 217, 218, 219, 220, 222, 223, 224, 225, 226, 228, 229, 230, 231, 232,
+	234, 235, 236, 237, 239, 240, 241, 242, 243, 245, 246, 247, 248, 249, 251, 252,
+	253, 254, 255, 257, 258, 259, 260, 261, 263, 264, 265, 266, 267, 269, 270, 271,
+	272, 273, 275, 276, 277, 278, 280, 281, 282, 283, 284, 286, 287, 288, 289, 290,
+	292, 293, 294, 295, 296, 298, 299, 300, 301, 302, 304, 305, 306, 307, 308, 310,
+	311, 312, 313, 314, 316, 317, 318, 319, 320, 322, 323, 324, 325, 327, 328, 329,
+	330, 331, 333, 334, 335, 336, 337, 339, 340, 341, 342, 343, 345, 346, 347, 348,
+	349, 351, 352, 353, 354, 355, 357, 358, 359, 360, 361, 363, 364, 365, 366, 368
+};
+
+#endif
\ No newline at end of file
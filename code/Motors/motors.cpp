@@ -11,10 +11,13 @@
 * Library for Motors and Encoders
 *
 * Functions: motor_pin_config, encoder_pin_config, set_motor_PWM,
-* set_motor_pin, set_motor_mode, drive_motor, update_motors,
-* left_encoder_interrupt, right_encoder_interrupt, motors_init
+* set_motor_pin, set_motor_mode, set_motor_output, set_motor_decay,
+* drive_motor, update_motors, record_encoder_edge, encoder_RPM,
+* left_encoder_interrupt, right_encoder_interrupt, benchmark_motor_PWM,
+* characterise_motors, motors_init
 *
-* Global Variables: left_encoder_count, right_encoder_count
+* Global Variables: left_encoder_count, right_encoder_count, left_odometer, right_odometer,
+* left_timing, right_timing, left_mode, right_mode, decay_mode, motor_reconnect
 */
 
 // Define parameters for Pin Change Interrupts Library
@@ -22,13 +25,27 @@
 #define NO_PORTB_PINCHANGES
 #define NO_PORTJ_PINCHANGES
 
-#include <Arduino.h>
+#include "../Support/platform.h"
 #include "../Support/digitalWriteFast.h"
+#include "../Timers/timers.h"
+#include "../Battery/battery.h"
+#include "../Stack/stack.h"
 #include "motors.h"
+#include "motor_lut.h"
 
 // Global variables
 volatile float left_encoder_count = 0;
 volatile float right_encoder_count = 0;
+volatile long left_odometer = 0;
+volatile long right_odometer = 0;
+volatile EncoderTiming left_timing = {{0, 0, 0}, 0, 0};
+volatile EncoderTiming right_timing = {{0, 0, 0}, 0, 0};
+
+// Motor output state
+unsigned char left_mode = COAST;
+unsigned char right_mode = COAST;
+unsigned char decay_mode = COAST;
+volatile unsigned char motor_reconnect = 0;		// OC5x outputs to reconnect at next PWM TOP
 
 /**********************************
 Function name	:	motor_pin_config
@@ -71,21 +88,33 @@ void encoder_pin_config()
 	pinMode(ENCB2, INPUT_PULLUP); // Encoder 2 - Channel B - PE5 - INT5
 	
 	// Attach interrupts for the encoder input pins
+	#ifdef BARE_METAL
+	// Any edge on INT2 and INT4, the handlers are bound to the vectors directly
+	EICRA = (EICRA & 0xCF) | 0x10;
+	EICRB = (EICRB & 0xFC) | 0x01;
+	EIFR = 0x14;
+	EIMSK |= 0x14;
+	#else
 	attachInterrupt(digitalPinToInterrupt(ENCA1), left_encoder_interrupt, CHANGE);
 	attachInterrupt(digitalPinToInterrupt(ENCB1), right_encoder_interrupt, CHANGE);
+	#endif
 }
 
 /**********************************
 Function name	:	set_motor_PWM
 Functionality	:	To set the PWM value for controlling the motor speed
-Arguments		:	Motor type (LEFT/RIGHT), PWM motor speed to set
+Arguments		:	Motor type (LEFT/RIGHT), PWM duty to set (0 to MOTOR_PWM_MAX)
 Return Value	:	None
-Example Call	:	set_motor_PWM(LEFT, 255)
+Example Call	:	set_motor_PWM(LEFT, MOTOR_PWM_MAX)
 ***********************************/
-void set_motor_PWM(int motor, unsigned char motor_speed)
+void set_motor_PWM(int motor, unsigned int duty)
 {
-	if (motor==LEFT)  analogWrite(EA, motor_speed);
-	if (motor==RIGHT) analogWrite(EB, motor_speed);
+	// 16-bit register writes share the TEMP register with the timer ISRs
+	unsigned char sreg = SREG;
+	cli();
+	if (motor==LEFT)  OCR5A = duty;		// EA - PL3 - OC5A
+	if (motor==RIGHT) OCR5B = duty;		// EB - PL4 - OC5B
+	SREG = sreg;
 }
 
 /**********************************
@@ -97,8 +126,12 @@ Example Call	:	set_motor_pin(LEFT, HIGH, LOW)
 ***********************************/
 void set_motor_pin(int motor, bool pin1, bool pin2)
 {
-	if (motor==LEFT)  PORTH = (pin1 << 5) | (pin2 << 4);
-	if (motor==RIGHT) PORTB = (pin2 << 5) | (pin1 << 6);
+	// Masked read-modify-write, PORTH also carries the buzzer pin driven from tone()
+	unsigned char sreg = SREG;
+	cli();
+	if (motor==LEFT)  PORTH = (PORTH & 0xCF) | (pin1 << 5) | (pin2 << 4);
+	if (motor==RIGHT) PORTB = (PORTB & 0x9F) | (pin2 << 5) | (pin1 << 6);
+	SREG = sreg;
 }
 
 /**********************************
@@ -117,41 +150,102 @@ void set_motor_mode(int motor, int mode)
 }
 
 /**********************************
-Function name	:	drive_motor
-Functionality	:	To set the direction/motion and speed of the robot based on the PWM value
-Arguments		:	Motor type (LEFT/RIGHT), PWM Value, Minimum PWM value for motor
+Function name	:	set_motor_output
+Functionality	:	To update the direction/motion logic and PWM duty of a motor together.
+					On a mode change the enable output is disconnected from the timer and
+					held low while the direction pins switch, and is reconnected by the
+					Timer 5 TOP interrupt once the new duty has been latched, so the old
+					duty is never applied in the new direction
+Arguments		:	Motor type (LEFT/RIGHT), Direction value, PWM duty (0 to MOTOR_PWM_MAX)
 Return Value	:	None
-Example Call	:	drive_motor(LEFT, 150, 80)
+Example Call	:	set_motor_output(LEFT, FORWARD, 200)
 ***********************************/
-void drive_motor(int motor, float PWM_value, float min_value)
+void set_motor_output(int motor, int mode, unsigned int duty)
 {
-	// Coast the motors
-	if (PWM_value == 0)
-	{
-		set_motor_PWM(motor, 0);
-		set_motor_mode(motor, COAST);
-	}
+	unsigned char *current_mode = (motor==LEFT) ? &left_mode : &right_mode;
+	unsigned char output = (motor==LEFT) ? 0x80 : 0x20;		// COM5A1/COM5B1
+	unsigned char sreg = SREG;
 	
-	// Move the robot forward
-	else if (PWM_value > 0)
+	cli();
+	if (mode != *current_mode)
 	{
-		PWM_value = map(PWM_value, 0, 255, min_value, 255);		// Map the PWM values
-		set_motor_PWM(motor, (unsigned char)PWM_value);			// Set motor speed
-		set_motor_mode(motor, FORWARD);							// Set motor direction
+		TCCR5A &= ~output;				// Enable pin follows PORTL (low)
+		set_motor_mode(motor, mode);	// Switch direction with the bridge disabled
+		*current_mode = mode;
+		
+		// Reconnect when OCR5x is updated from its buffer at TOP. The new duty is
+		// buffered before ICF5 is cleared, so a TOP in between cannot reconnect the old duty
+		set_motor_PWM(motor, duty);
+		motor_reconnect |= output;
+		TIFR5 = 0x20;					// Clear ICF5
+		TIMSK5 |= 0x20;					// Enable Timer 5 capture (TOP) interrupt
 	}
+	else set_motor_PWM(motor, duty);
+	SREG = sreg;
+}
+
+/**********************************
+Function name	:	set_motor_decay
+Functionality	:	To select how a motor with zero command is stopped
+Arguments		:	Decay mode (COAST - free running, BRAKE - fast motor stop)
+Return Value	:	None
+Example Call	:	set_motor_decay(BRAKE)
+***********************************/
+void set_motor_decay(int mode)
+{
+	decay_mode = mode;
+}
+
+/**********************************
+Function name	:	ISR(TIMER5_CAPT_vect)
+Functionality	:	ISR at PWM TOP to reconnect motor enable outputs after a mode change
+Arguments		:	Timer 5 input capture vector (flag is set at TOP = ICR5)
+Return Value	:	None
+Example Call	:	Called automatically
+***********************************/
+ISR(TIMER5_CAPT_vect)
+{
+	TCCR5A |= motor_reconnect;
+	motor_reconnect = 0;
+	TIMSK5 &= ~0x20;
+}
+
+/**********************************
+Function name	:	drive_motor
+Functionality	:	To set the direction/motion and speed of the robot based on the PWM value.
+					The duty is read from the inverse characteristic table of the motor
+					so that the wheel speed is linear in the PWM value
+Arguments		:	Motor type (LEFT/RIGHT), PWM Value (-255 to 255)
+Return Value	:	None
+Example Call	:	drive_motor(LEFT, 150)
+***********************************/
+void drive_motor(int motor, float PWM_value)
+{
+	unsigned int duty=0;
+	unsigned char index=0;
 	
-	// Move the robot back
-	else if (PWM_value < 0)
+	// Stop the motors, brake needs the bridge enabled with both inputs high
+	if (PWM_value == 0)
 	{
-		PWM_value = map(PWM_value, 0, -255, min_value, 255);	// Map the PWM values
-		set_motor_PWM(motor, (unsigned char)PWM_value);			// Set motor speed
-		set_motor_mode(motor, BACK);							// Set motor direction
+		if (decay_mode == BRAKE) set_motor_output(motor, BRAKE, MOTOR_PWM_MAX);
+		else set_motor_output(motor, COAST, 0);
+		return;
 	}
+	
+	// Look up the duty for the command magnitude
+	index = constrain(fabs(PWM_value) + 0.5, 1, 255);
+	if (motor == LEFT) duty = pgm_read_word(&left_motor_lut[index]);
+	else duty = pgm_read_word(&right_motor_lut[index]);
+	
+	// Set motor direction and speed
+	if (PWM_value > 0) set_motor_output(motor, FORWARD, duty);
+	else set_motor_output(motor, BACK, duty);
 }
 
 /**********************************
 Function name	:	update_motors
-Functionality	:	To update the speed and direction od motors based on the PID values computed
+Functionality	:	To update the speed and direction od motors based on the PID values computed.
+					The command is scaled up as the battery sags to keep the effective motor voltage constant
 Arguments		:	PID value computed, Left/Right rotation offset values
 Return Value	:	None
 Example Call	:	update_motors(150, 10, -10)
@@ -159,14 +253,74 @@ Example Call	:	update_motors(150, 10, -10)
 void update_motors(float PID_output, float left_offset, float right_offset)
 {
 	float left_PWM=0, right_PWM=0;
+	float gain = battery_compensation();
 	
-	// Add rotation offsets and constrain the output
-	left_PWM = constrain(PID_output + left_offset, -255, 255);
-	right_PWM = constrain(PID_output + right_offset, -255, 255);
+	// Add rotation offsets, compensate for battery voltage and constrain the output
+	left_PWM = constrain((PID_output + left_offset)*gain, -255, 255);
+	right_PWM = constrain((PID_output + right_offset)*gain, -255, 255);
 	
 	// Drive the motors
-	drive_motor(LEFT, left_PWM, LEFT_PWM_MIN);
-	drive_motor(RIGHT, right_PWM, RIGHT_PWM_MIN);
+	drive_motor(LEFT, left_PWM);
+	drive_motor(RIGHT, right_PWM);
+}
+
+/**********************************
+Function name	:	record_encoder_edge
+Functionality	:	To store the timestamp and direction of an encoder edge
+Arguments		:	Encoder timing structure, Direction of the edge, Edge timestamp
+Return Value	:	None
+Example Call	:	record_encoder_edge(&left_timing, 1, epoch_ticks())
+***********************************/
+void record_encoder_edge(volatile EncoderTiming *timing, signed char direction, unsigned long now)
+{
+	// Periods across a direction change are not valid
+	if (direction != timing->direction)
+	{
+		timing->direction = direction;
+		timing->edges = 0;
+	}
+	
+	timing->edge_time[2] = timing->edge_time[1];
+	timing->edge_time[1] = timing->edge_time[0];
+	timing->edge_time[0] = now;
+	if (timing->edges < 3) timing->edges++;
+}
+
+/**********************************
+Function name	:	encoder_RPM
+Functionality	:	To estimate the wheel velocity by blending the edge period
+					measurement at low speed with the count difference at high speed
+Arguments		:	Encoder timing structure, Change in count over RPM_PERIOD, Current time
+Return Value	:	Wheel velocity in RPM
+Example Call	:	encoder_RPM(&left_timing, 3, epoch_ticks())
+***********************************/
+float encoder_RPM(volatile EncoderTiming *timing, float counts, unsigned long now)
+{
+	float count_RPM=0, period_RPM=0, weight=0;
+	unsigned long period=0, elapsed=0;
+	
+	//		 (Change in encoder count) * (60 sec/1 min)
+	// RPM = __________________________________________
+	//		 (Change in time --> 20ms) * (CPR --> 420)
+	count_RPM = (counts * 60)/(RPM_PERIOD * ENCODER_CPR);
+	
+	// Edge period over a full channel A cycle (two edges) cancels duty cycle errors
+	elapsed = now - timing->edge_time[0];
+	if ((timing->edges >= 3) && (elapsed < EDGE_TIMEOUT))
+	{
+		period = (timing->edge_time[0] - timing->edge_time[2]) / 2;
+		
+		// No edge for longer than the last period means the wheel has slowed down
+		if (elapsed > period) period = elapsed;
+		
+		period_RPM = timing->direction * (60.0 * TIMER4_TICKS_PER_SEC)/((float)period * ENCODER_CPR);
+	}
+	
+	// Blend from edge timing at low speed to count difference at high speed
+	weight = (abs(counts) - RPM_BLEND_LOW)/(float)(RPM_BLEND_HIGH - RPM_BLEND_LOW);
+	weight = constrain(weight, 0, 1);
+	
+	return (weight*count_RPM + (1-weight)*period_RPM);
 }
 
 //                           _______         _______
@@ -183,11 +337,19 @@ Example Call	:	Called automatically
 ***********************************/
 void left_encoder_interrupt()
 {
+	unsigned long now = epoch_ticks();
+	signed char direction;
 	int state = digitalReadFast(ENCA1);
 	if(digitalReadFast(ENCA2)) 
-	state ? left_encoder_count-- : left_encoder_count++;
+	direction = state ? -1 : 1;
 	else 
-	state ? left_encoder_count++ : left_encoder_count--;
+	direction = state ? 1 : -1;
+	
+	STACK_ISR_BEGIN();
+	left_encoder_count += direction;
+	left_odometer += direction;
+	record_encoder_edge(&left_timing, direction, now);
+	STACK_ISR_END(STACK_ISR_ENCODER);
 }
 
 /**********************************
@@ -199,12 +361,120 @@ Example Call	:	Called automatically
 ***********************************/
 void right_encoder_interrupt()
 {
+	unsigned long now = epoch_ticks();
+	signed char direction;
 	int state = digitalReadFast(ENCB1);
 	if(digitalReadFast(ENCB2)) 
-	state ? right_encoder_count++ : right_encoder_count--;
+	direction = state ? 1 : -1;
 	else 
-	state ? right_encoder_count-- : right_encoder_count++;
+	direction = state ? -1 : 1;
+	
+	STACK_ISR_BEGIN();
+	right_encoder_count += direction;
+	right_odometer += direction;
+	record_encoder_edge(&right_timing, direction, now);
+	STACK_ISR_END(STACK_ISR_ENCODER);
+}
+
+#ifdef BARE_METAL
+/**********************************
+Function name	:	ISR(INT2_vect), ISR(INT4_vect)
+Functionality	:	Encoder channel A edge ISRs, without the attachInterrupt() function
+					pointer call of the Arduino core
+Arguments		:	External interrupt vector
+Return Value	:	None
+Example Call	:	Called automatically
+***********************************/
+ISR(INT2_vect) {left_encoder_interrupt();}
+ISR(INT4_vect) {right_encoder_interrupt();}
+#endif
+
+#ifdef MOTOR_BENCHMARK
+/**********************************
+Function name	:	benchmark_motor_PWM
+Functionality	:	To measure the cost of a duty update with analogWrite() and with
+					the direct Timer 5 register write, result is sent over Serial
+Arguments		:	None
+Return Value	:	None
+Example Call	:	benchmark_motor_PWM()
+***********************************/
+void benchmark_motor_PWM()
+{
+	unsigned long start=0, direct_ticks=0;
+	
+	// Timer 4 runs at F_CPU, so ticks per 1000 calls / 1000 = CPU cycles per call
+	#ifndef BARE_METAL
+	// Arduino core duty update
+	unsigned long analog_ticks=0;
+	start = epoch_ticks();
+	for (unsigned int i=0; i<1000; i++) analogWrite(EA, i & 0xFF);
+	analog_ticks = epoch_ticks() - start;
+	
+	// analogWrite() reconfigures Timer 5, restore the motor PWM setup
+	timer5_init();
+	Serial.print("analogWrite cycles/call: ");
+	Serial.println(analog_ticks/1000);
+	#endif
+	
+	// Direct register duty update
+	start = epoch_ticks();
+	for (unsigned int i=0; i<1000; i++) set_motor_PWM(LEFT, i & 0xFF);
+	direct_ticks = epoch_ticks() - start;
+	set_motor_PWM(LEFT, 0);
+	
+	Serial.print("set_motor_PWM cycles/call: ");
+	Serial.println(direct_ticks/1000);
+}
+#endif
+
+#ifdef MOTOR_CHARACTERISE
+/**********************************
+Function name	:	characterise_motors
+Functionality	:	To sweep the PWM duty of both motors and send the steady state RPM
+					of each wheel over Serial as "duty,left_RPM,right_RPM" lines
+Arguments		:	None
+Return Value	:	None
+Example Call	:	characterise_motors()
+***********************************/
+void characterise_motors()
+{
+	unsigned long start=0;
+	float left_start=0, right_start=0;
+	float left_RPM=0, right_RPM=0;
+	
+	Serial.println("duty,left_RPM,right_RPM");
+	
+	for (unsigned int duty=0; duty<=MOTOR_PWM_MAX; duty+=SWEEP_STEP)
+	{
+		set_motor_output(LEFT, FORWARD, duty);
+		set_motor_output(RIGHT, FORWARD, duty);
+		
+		// Wait for the wheels to reach steady state
+		start = epoch();
+		while ((epoch() - start) < SWEEP_SETTLE);
+		
+		// Count encoder edges over the sample window
+		left_start = left_encoder_count;
+		right_start = right_encoder_count;
+		start = epoch();
+		while ((epoch() - start) < SWEEP_SAMPLE);
+		
+		left_RPM = (left_encoder_count - left_start)*60000.0/(ENCODER_CPR*SWEEP_SAMPLE);
+		right_RPM = (right_encoder_count - right_start)*60000.0/(ENCODER_CPR*SWEEP_SAMPLE);
+		
+		Serial.print(duty);
+		Serial.print(",");
+		Serial.print(left_RPM);
+		Serial.print(",");
+		Serial.println(right_RPM);
+	}
+	
+	// Stop and stay here, the robot cannot balance in this mode
+	set_motor_output(LEFT, COAST, 0);
+	set_motor_output(RIGHT, COAST, 0);
+	while (true);
 }
+#endif
 
 /**********************************
 Function name	:	motors_init
@@ -11,7 +11,8 @@
 * Library for Motors and Encoders
 */
 
-#include <Arduino.h>
+#include "../Support/platform.h"
+#include "../Timers/timers.h"
 
 #ifndef MOTORS_H_
 #define MOTORS_H_
@@ -36,12 +37,42 @@
 #define RIGHT	4
 #define BRAKE	5
 
-// Define Minimum PWM Values for Motors
-#define LEFT_PWM_MIN 35
-#define RIGHT_PWM_MIN 42
+// Uncomment to print the cost of a PWM duty update at start-up
+//#define MOTOR_BENCHMARK
+
+// Uncomment to sweep the PWM duty and print the steady state wheel RPM at start-up
+// Output is the input of Tools/motor_lut.cpp, run with the wheels off the ground
+//#define MOTOR_CHARACTERISE
+
+// Define PWM Duty Range (Timer 5 TOP)
+#define MOTOR_PWM_MAX	TIMER5_TOP
+
+// Characterisation Sweep Parameters
+#define SWEEP_STEP			8			// Duty increment per step (Timer 5 counts)
+#define SWEEP_SETTLE		400			// Time for the wheel speed to settle (ms)
+#define SWEEP_SAMPLE		500			// Encoder counting window (ms)
+
+// Encoder and Velocity Estimation Parameters
+#define ENCODER_CPR			420			// Encoder counts per wheel revolution
+#define RPM_PERIOD			0.02		// Velocity estimation period (s)
+#define RPM_BLEND_LOW		4			// Counts per period below which only edge timing is used
+#define RPM_BLEND_HIGH		12			// Counts per period above which only count difference is used
+#define EDGE_TIMEOUT		1474500UL	// Wheel is stopped after 100ms without edges (Timer 4 ticks)
+
+// Structure to hold the timestamps of the latest encoder edges
+typedef struct EncoderTiming
+{
+	unsigned long edge_time[3];		// Latest three edge timestamps (Timer 4 ticks)
+	unsigned char edges;			// Number of valid timestamps in the same direction
+	signed char direction;			// Direction of the latest edge (+1/-1)
+};
 
 extern volatile float left_encoder_count;
 extern volatile float right_encoder_count;
+extern volatile long left_odometer;		// Encoder counts since power on, never reset
+extern volatile long right_odometer;
+extern volatile EncoderTiming left_timing;
+extern volatile EncoderTiming right_timing;
 
 
 // Function Declarations
@@ -71,11 +102,11 @@ void encoder_pin_config();
 /**********************************
 Function name	:	set_motor_PWM
 Functionality	:	To set the PWM value for controlling the motor speed
-Arguments		:	Motor type (LEFT/RIGHT), PWM motor speed to set
+Arguments		:	Motor type (LEFT/RIGHT), PWM duty to set (0 to MOTOR_PWM_MAX)
 Return Value	:	None
-Example Call	:	set_motor_PWM(LEFT, 255)
+Example Call	:	set_motor_PWM(LEFT, MOTOR_PWM_MAX)
 ***********************************/
-void set_motor_PWM(int motor, unsigned char motor_speed);
+void set_motor_PWM(int motor, unsigned int duty);
 
 /**********************************
 Function name	:	set_motor_pin
@@ -95,24 +126,68 @@ Example Call	:	set_motor_mode(LEFT, FORWARD)
 ***********************************/
 void set_motor_mode(int motor, int mode);
 
+/**********************************
+Function name	:	set_motor_output
+Functionality	:	To update the direction/motion logic and PWM duty of a motor together.
+					On a mode change the enable output is disconnected from the timer and
+					held low while the direction pins switch, and is reconnected by the
+					Timer 5 TOP interrupt once the new duty has been latched, so the old
+					duty is never applied in the new direction
+Arguments		:	Motor type (LEFT/RIGHT), Direction value, PWM duty (0 to MOTOR_PWM_MAX)
+Return Value	:	None
+Example Call	:	set_motor_output(LEFT, FORWARD, 200)
+***********************************/
+void set_motor_output(int motor, int mode, unsigned int duty);
+
+/**********************************
+Function name	:	set_motor_decay
+Functionality	:	To select how a motor with zero command is stopped
+Arguments		:	Decay mode (COAST - free running, BRAKE - fast motor stop)
+Return Value	:	None
+Example Call	:	set_motor_decay(BRAKE)
+***********************************/
+void set_motor_decay(int mode);
+
 /**********************************
 Function name	:	drive_motor
-Functionality	:	To set the direction/motion and speed of the robot based on the PWM value
-Arguments		:	Motor type (LEFT/RIGHT), PWM Value, Minimum PWM value for motor
+Functionality	:	To set the direction/motion and speed of the robot based on the PWM value.
+					The duty is read from the inverse characteristic table of the motor
+					so that the wheel speed is linear in the PWM value
+Arguments		:	Motor type (LEFT/RIGHT), PWM Value (-255 to 255)
 Return Value	:	None
-Example Call	:	drive_motor(LEFT, 150, 80)
+Example Call	:	drive_motor(LEFT, 150)
 ***********************************/
-void drive_motor(int motor, float PWM_value, float min_value);
+void drive_motor(int motor, float PWM_value);
 
 /**********************************
 Function name	:	update_motors
-Functionality	:	To update the speed and direction od motors based on the PID values computed
+Functionality	:	To update the speed and direction od motors based on the PID values computed.
+					The command is scaled up as the battery sags to keep the effective motor voltage constant
 Arguments		:	PID value computed, Left/Right rotation offset values
 Return Value	:	None
 Example Call	:	update_motors(150, 10, -10)
 ***********************************/
 void update_motors(float PID_output, float left_offset, float right_offset);
 
+/**********************************
+Function name	:	record_encoder_edge
+Functionality	:	To store the timestamp and direction of an encoder edge
+Arguments		:	Encoder timing structure, Direction of the edge, Edge timestamp
+Return Value	:	None
+Example Call	:	record_encoder_edge(&left_timing, 1, epoch_ticks())
+***********************************/
+void record_encoder_edge(volatile EncoderTiming *timing, signed char direction, unsigned long now);
+
+/**********************************
+Function name	:	encoder_RPM
+Functionality	:	To estimate the wheel velocity by blending the edge period
+					measurement at low speed with the count difference at high speed
+Arguments		:	Encoder timing structure, Change in count over RPM_PERIOD, Current time
+Return Value	:	Wheel velocity in RPM
+Example Call	:	encoder_RPM(&left_timing, 3, epoch_ticks())
+***********************************/
+float encoder_RPM(volatile EncoderTiming *timing, float counts, unsigned long now);
+
 /**********************************
 Function name	:	left_encoder_interrupt
 Functionality	:	To handle interrupt for left encoder channel A
@@ -131,6 +206,30 @@ Example Call	:	Called automatically
 ***********************************/
 void right_encoder_interrupt();
 
+#ifdef MOTOR_BENCHMARK
+/**********************************
+Function name	:	benchmark_motor_PWM
+Functionality	:	To measure the cost of a duty update with analogWrite() and with
+					the direct Timer 5 register write, result is sent over Serial
+Arguments		:	None
+Return Value	:	None
+Example Call	:	benchmark_motor_PWM()
+***********************************/
+void benchmark_motor_PWM();
+#endif
+
+#ifdef MOTOR_CHARACTERISE
+/**********************************
+Function name	:	characterise_motors
+Functionality	:	To sweep the PWM duty of both motors and send the steady state RPM
+					of each wheel over Serial as "duty,left_RPM,right_RPM" lines
+Arguments		:	None
+Return Value	:	None
+Example Call	:	characterise_motors()
+***********************************/
+void characterise_motors();
+#endif
+
 /**********************************
 Function name	:	motors_init
 Functionality	:	To initiate the motors and encoders
@@ -0,0 +1,127 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: odometry.cpp
+*
+* Created: 19-Oct-26 4:12:02 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for fixed point differential drive wheel odometry
+*
+* Functions: odometry_sin, odometry_cos, odometry_update, odometry_x,
+* odometry_y, odometry_heading
+*
+* Global Variables: odometry, sine_table
+*/
+
+#include "../Support/platform.h"
+#include <avr/pgmspace.h>
+#include "../Motors/motors.h"
+#include "odometry.h"
+
+// Structure Initialization
+Odometry odometry = {0, 0, 0, 0, 0};
+
+// Quarter wave sine table, 1024 steps per turn (Q15)
+const int sine_table[257] PROGMEM =
+{
+	    0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+	 2410,  2611,  2811,  3012,  3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+	 4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6786,  6983,
+	 7179,  7375,  7571,  7767,  7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+	 9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+	11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+	14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+	16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+	18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+	20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+	22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+	23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+	25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+	26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+	28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+	29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+	30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+	31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+	31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+	32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+	32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+	32757, 32761, 32765, 32766, 32767
+};
+
+/**********************************
+Function name	:	odometry_sin
+Functionality	:	To compute the sine of an angle from a quarter wave table
+Arguments		:	Angle (65536 = 360 deg)
+Return Value	:	Sine (Q15)
+Example Call	:	odometry_sin(16384)
+***********************************/
+int odometry_sin(unsigned int angle)
+{
+	unsigned int index = (angle >> 6) & 0xFF;
+	unsigned char quadrant = angle >> 14;
+	int value;
+	
+	// Mirror the table in the second and fourth quadrants, negate in the lower half
+	if (quadrant & 0x01) index = 256 - index;
+	value = pgm_read_word(&sine_table[index]);
+	
+	return (quadrant & 0x02) ? -value : value;
+}
+
+/**********************************
+Function name	:	odometry_cos
+Functionality	:	To compute the cosine of an angle from a quarter wave table
+Arguments		:	Angle (65536 = 360 deg)
+Return Value	:	Cosine (Q15)
+Example Call	:	odometry_cos(16384)
+***********************************/
+int odometry_cos(unsigned int angle)
+{
+	return odometry_sin(angle + 16384);
+}
+
+/**********************************
+Function name	:	odometry_update
+Functionality	:	To integrate the pose from the odometer counts since the last update,
+					the midpoint heading is used for the position step
+Arguments		:	None
+Return Value	:	None
+Example Call	:	odometry_update()
+***********************************/
+void odometry_update()
+{
+	long left=0, right=0, distance=0;
+	long left_delta=0, right_delta=0;
+	unsigned long heading_delta=0;
+	unsigned int midpoint=0;
+	unsigned char sreg = SREG;
+	
+	// Odometer counts are updated by the encoder interrupts
+	cli();
+	left = left_odometer;
+	right = right_odometer;
+	SREG = sreg;
+	
+	left_delta = left - odometry.left_count;
+	right_delta = right - odometry.right_count;
+	odometry.left_count = left;
+	odometry.right_count = right;
+	
+	// Distance of the robot centre (um, Q8) and heading change (wraps at 360 deg)
+	distance = (left_delta + right_delta)*ODOMETRY_DIST_Q8/2;
+	heading_delta = (right_delta - left_delta)*ODOMETRY_HEADING_STEP;
+	midpoint = (odometry.heading + (long)heading_delta/2) >> 16;
+	
+	// Q8 x Q15 product, rounded back to um
+	odometry.x += ((long long)distance*odometry_cos(midpoint) + (1LL << 22)) >> 23;
+	odometry.y += ((long long)distance*odometry_sin(midpoint) + (1LL << 22)) >> 23;
+	odometry.heading += heading_delta;
+}
+
+// Getter functions
+long odometry_x() {return odometry.x/1000;}
+long odometry_y() {return odometry.y/1000;}
+float odometry_heading() {return (long)odometry.heading*(180.0/2147483648.0);}
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: odometry.h
+*
+* Created: 19-Oct-26 4:12:02 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for fixed point differential drive wheel odometry
+*/
+
+#ifndef ODOMETRY_H_
+#define ODOMETRY_H_
+
+// Robot Geometry (um), measure and update for the robot
+#define WHEEL_DIAMETER		68000
+#define WHEEL_BASE			180000		// Distance between the wheel contact points
+
+// Fixed point scale factors
+// Distance per encoder count (um, Q8) and heading change per count of wheel difference (2^32 = 360 deg)
+#define ODOMETRY_DIST_Q8		((long)(PI*WHEEL_DIAMETER*256.0/ENCODER_CPR + 0.5))
+#define ODOMETRY_HEADING_STEP	((long)(WHEEL_DIAMETER*4294967296.0/(2.0*ENCODER_CPR*WHEEL_BASE) + 0.5))
+
+// Structure to hold the pose of the robot, the origin is the pose at power on
+typedef struct Odometry
+{
+	long x;						// Position along the initial heading (um)
+	long y;						// Position to the left of the initial heading (um)
+	unsigned long heading;		// Heading, counter-clockwise positive (2^32 = 360 deg)
+	
+	// Odometer counts at the last update
+	long left_count;
+	long right_count;
+};
+
+extern Odometry odometry;
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	odometry_sin
+Functionality	:	To compute the sine of an angle from a quarter wave table
+Arguments		:	Angle (65536 = 360 deg)
+Return Value	:	Sine (Q15)
+Example Call	:	odometry_sin(16384)
+***********************************/
+int odometry_sin(unsigned int angle);
+
+/**********************************
+Function name	:	odometry_cos
+Functionality	:	To compute the cosine of an angle from a quarter wave table
+Arguments		:	Angle (65536 = 360 deg)
+Return Value	:	Cosine (Q15)
+Example Call	:	odometry_cos(16384)
+***********************************/
+int odometry_cos(unsigned int angle);
+
+/**********************************
+Function name	:	odometry_update
+Functionality	:	To integrate the pose from the odometer counts since the last update,
+					the midpoint heading is used for the position step
+Arguments		:	None
+Return Value	:	None
+Example Call	:	odometry_update()
+***********************************/
+void odometry_update();
+
+/**********************************
+Function name	:	odometry_x
+Functionality	:	Returns the X position of the robot
+Arguments		:	None
+Return Value	:	X position (mm)
+Example Call	:	odometry_x()
+***********************************/
+long odometry_x();
+
+/**********************************
+Function name	:	odometry_y
+Functionality	:	Returns the Y position of the robot
+Arguments		:	None
+Return Value	:	Y position (mm)
+Example Call	:	odometry_y()
+***********************************/
+long odometry_y();
+
+/**********************************
+Function name	:	odometry_heading
+Functionality	:	Returns the heading of the robot
+Arguments		:	None
+Return Value	:	Heading (-180 to 180 deg)
+Example Call	:	odometry_heading()
+***********************************/
+float odometry_heading();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: pid.cpp
+*
+* Created: 19-Oct-26 5:20:28 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for the angle PID step. Plain C maths without the Arduino core, so that
+* Tools/gain_map.cpp runs the same controller as the robot
+*
+* Functions: pid_limit, pid_angle_update
+* Global Variables: None
+*/
+
+#include <math.h>
+#include "pid.h"
+
+/**********************************
+Function name	:	pid_limit
+Functionality	:	To constrain a value to the PWM range, as constrain() of the Arduino core
+Arguments		:	Value
+Return Value	:	Value within -PID_OUTPUT_LIMIT to PID_OUTPUT_LIMIT
+Example Call	:	pid_limit(pid->output)
+***********************************/
+float pid_limit(float value)
+{
+	if (value < -PID_OUTPUT_LIMIT) return -PID_OUTPUT_LIMIT;
+	if (value > PID_OUTPUT_LIMIT) return PID_OUTPUT_LIMIT;
+	return value;
+}
+
+/**********************************
+Function name	:	pid_angle_update
+Functionality	:	To compute the PWM output of the angle PID from its set point and
+					position, with the conservative gains for errors below
+					ANGLE_AGGRESSIVE_ERROR and no output once the robot has fallen
+Arguments		:	Angle PID
+Return Value	:	None
+Example Call	:	pid_angle_update(&angle)
+***********************************/
+void pid_angle_update(PID *pid)
+{
+	float KP=0, KI=0, KD=0;
+	
+	// Compute tilt angle error
+	pid->error = pid->set_point - pid->position;
+	
+	// Turn motors off if robot falls beyond recoverable angle and await human rescue
+	if (fabsf(pid->error) >= ANGLE_FALL_ERROR)
+	{
+		pid->output = 0;
+		return;
+	}
+	
+	// Conservative PID gains for small errors, aggressive gains otherwise
+	if (fabsf(pid->error) < ANGLE_AGGRESSIVE_ERROR)
+	{
+		KP = pid->con_KP;
+		KI = pid->con_KI;
+		KD = pid->con_KD;
+	}
+	
+	else
+	{
+		KP = pid->agr_KP;
+		KI = pid->agr_KI;
+		KD = pid->agr_KD;
+	}
+	
+	// Derivative on the position, integral sum constrained to prevent wind-up
+	pid->derivative = pid->position - pid->last_position;
+	pid->integral = pid_limit(pid->integral + KI*pid->error);
+	
+	// Constrain the output to the PWM range
+	pid->output = (KP*pid->error) + (pid->integral) - (KD*pid->derivative);
+	pid->output = pid_limit(pid->output);
+	
+	// Store variable for next iteration
+	pid->last_position = pid->position;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: pid.h
+*
+* Created: 19-Oct-26 5:20:28 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* PID structure and the angle PID step, shared by the firmware and the host tools
+*/
+
+#ifndef PID_H_
+#define PID_H_
+
+#define ANGLE_AGGRESSIVE_ERROR	3.0		// Error from which the aggressive gains are used (deg)
+#define ANGLE_FALL_ERROR		75		// Error beyond which the robot has fallen (deg)
+#define PID_OUTPUT_LIMIT		255		// PWM range of the output and the integral sum
+
+// PID Structure Definition
+typedef struct PID
+{
+	float con_KP;			// Conservative proportional gain
+	float con_KI;			// Conservative integral gain
+	float con_KD;			// Conservative derivative gain
+	
+	float agr_KP;			// Aggressive proportional gain
+	float agr_KI;			// Aggressive integral gain
+	float agr_KD; 			// Aggressive derivative gain
+	
+	float set_point;		// Set point value
+	float error;			// Error value
+	float position;			// Current position
+	float last_position;	// Previous position
+	
+	float integral;			// Integral sum
+	float derivative;		// Derivative term
+	float output; 			// PID output
+	int direction;			// Controller direction
+};
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	pid_limit
+Functionality	:	To constrain a value to the PWM range, as constrain() of the Arduino core
+Arguments		:	Value
+Return Value	:	Value within -PID_OUTPUT_LIMIT to PID_OUTPUT_LIMIT
+Example Call	:	pid_limit(pid->output)
+***********************************/
+float pid_limit(float value);
+
+/**********************************
+Function name	:	pid_angle_update
+Functionality	:	To compute the PWM output of the angle PID from its set point and
+					position, with the conservative gains for errors below
+					ANGLE_AGGRESSIVE_ERROR and no output once the robot has fallen
+Arguments		:	Angle PID
+Return Value	:	None
+Example Call	:	pid_angle_update(&angle)
+***********************************/
+void pid_angle_update(PID *pid);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: profile.cpp
+*
+* Created: 19-Oct-26 4:01:31 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for jerk limited (S-curve) motion profiles
+*
+* Functions: profile_reset, profile_update
+* Global Variables: None
+*/
+
+#include <math.h>
+#include "profile.h"
+
+/**********************************
+Function name	:	profile_reset
+Functionality	:	To bring the profile to rest at zero position
+Arguments		:	Motion profile
+Return Value	:	None
+Example Call	:	profile_reset(&drive_profile)
+***********************************/
+void profile_reset(MotionProfile *profile)
+{
+	profile->position = 0;
+	profile->velocity = 0;
+	profile->acceleration = 0;
+}
+
+/**********************************
+Function name	:	profile_update
+Functionality	:	To advance the profile towards a target velocity by one time step.
+					Acceleration is ramped at the jerk limit and brought back to zero
+					exactly when the target velocity is reached
+Arguments		:	Motion profile, Target velocity (RPM), Time step (s)
+Return Value	:	Change in position set-point (revolutions)
+Example Call	:	profile_update(&drive_profile, 155, 0.02)
+***********************************/
+float profile_update(MotionProfile *profile, float target_velocity, float dt)
+{
+	float error=0, desired_acceleration=0, jerk_step=0, last_velocity=0, step=0;
+	
+	last_velocity = profile->velocity;
+	error = target_velocity - profile->velocity;
+	jerk_step = profile->max_jerk*dt;
+	
+	// Largest acceleration from which the jerk limit can still bring the
+	// acceleration to zero before the remaining velocity error is used up
+	desired_acceleration = sqrt(2.0*profile->max_jerk*fabs(error));
+	if (desired_acceleration > profile->max_acceleration) desired_acceleration = profile->max_acceleration;
+	if (error < 0) desired_acceleration = -desired_acceleration;
+	
+	// Ramp the acceleration at the jerk limit
+	if ((desired_acceleration - profile->acceleration) > jerk_step) profile->acceleration += jerk_step;
+	else if ((profile->acceleration - desired_acceleration) > jerk_step) profile->acceleration -= jerk_step;
+	else profile->acceleration = desired_acceleration;
+	
+	// Integrate velocity and settle on the target instead of overshooting it
+	profile->velocity += profile->acceleration*dt;
+	if (((error > 0) && (profile->velocity >= target_velocity)) ||
+		((error < 0) && (profile->velocity <= target_velocity)) || (error == 0))
+	{
+		profile->velocity = target_velocity;
+		profile->acceleration = 0;
+	}
+	
+	// Integrate position (trapezoidal rule) in revolutions
+	step = (last_velocity + profile->velocity)*0.5*dt/60.0;
+	profile->position += step;
+	
+	return step;
+}
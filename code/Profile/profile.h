@@ -0,0 +1,51 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: profile.h
+*
+* Created: 19-Oct-26 4:01:31 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for jerk limited (S-curve) motion profiles
+*/
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+// Structure to hold the state and limits of a motion profile
+typedef struct MotionProfile
+{
+	float position;			// Position set-point (revolutions)
+	float velocity;			// Velocity set-point (RPM)
+	float acceleration;		// Acceleration set-point (RPM/s)
+	
+	float max_acceleration;	// Acceleration limit (RPM/s)
+	float max_jerk;			// Jerk limit (RPM/s^2), very large values give a trapezoidal profile
+};
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	profile_reset
+Functionality	:	To bring the profile to rest at zero position
+Arguments		:	Motion profile
+Return Value	:	None
+Example Call	:	profile_reset(&drive_profile)
+***********************************/
+void profile_reset(MotionProfile *profile);
+
+/**********************************
+Function name	:	profile_update
+Functionality	:	To advance the profile towards a target velocity by one time step.
+					Acceleration is ramped at the jerk limit and brought back to zero
+					exactly when the target velocity is reached
+Arguments		:	Motion profile, Target velocity (RPM), Time step (s)
+Return Value	:	Change in position set-point (revolutions)
+Example Call	:	profile_update(&drive_profile, 155, 0.02)
+***********************************/
+float profile_update(MotionProfile *profile, float target_velocity, float dt);
+
+#endif
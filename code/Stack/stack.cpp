@@ -0,0 +1,182 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: stack.cpp
+*
+* Created: 19-Oct-26 4:47:48 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for measuring the stack use against the 8KB SRAM. The free RAM between the
+* static data and the stack is painted at start-up, the lowest overwritten byte is the
+* high-water mark of the stack. STACK_PROFILE also measures the stack used by each ISR.
+* Tools/ram_budget.cpp checks the static data plus the worst case stack at build time.
+*
+* Functions: stack_paint, stack_high_water, stack_free, stack_static, stack_isr_begin,
+* stack_isr_end, stack_isr_depth
+*
+* Global Variables: stack_lowest, isr_window, isr_body, isr_depth
+*/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "stack.h"
+
+// End of the static data, from the linker (malloc() is not used, so there is no heap)
+extern unsigned char __heap_start;
+
+// Lowest byte found overwritten by the stack, RAMEND + 1 until the first scan.
+// Also lowered by the ISRs under STACK_PROFILE
+unsigned char * volatile stack_lowest = (unsigned char*)RAMEND + 1;
+
+#ifdef STACK_PROFILE
+// ISRs do not nest, so one window is painted at a time
+unsigned char *isr_window = 0;
+unsigned char *isr_body = 0;
+unsigned int isr_depth[STACK_ISR_COUNT];
+#endif
+
+/**********************************
+Function name	:	stack_paint
+Functionality	:	To fill the free RAM below the stack with STACK_CANARY, called first
+					in setup() with interrupts still disabled
+Arguments		:	None
+Return Value	:	None
+Example Call	:	stack_paint()
+***********************************/
+void stack_paint()
+{
+	unsigned char sreg = SREG;
+	unsigned char *top = 0;
+	
+	// The Arduino core enables interrupts before setup(), an ISR frame below the
+	// stack pointer must not be painted over
+	cli();
+	top = (unsigned char*)(uintptr_t)SP;
+	for (unsigned char *p = &__heap_start; p < top; p++) *p = STACK_CANARY;
+	SREG = sreg;
+}
+
+/**********************************
+Function name	:	stack_high_water
+Functionality	:	To find the deepest the stack has been since stack_paint(). Scans the
+					free RAM from the bottom (about 2ms), call it from the telemetry task
+Arguments		:	None
+Return Value	:	Stack used (bytes below RAMEND)
+Example Call	:	stack_high_water()
+***********************************/
+unsigned int stack_high_water()
+{
+	unsigned char sreg = 0;
+	unsigned char *p = &__heap_start;
+	unsigned char *limit = 0;
+	unsigned int used = 0;
+	
+	sreg = SREG;
+	cli();
+	limit = stack_lowest;
+	SREG = sreg;
+	
+	// From the bottom, so that canary bytes left in unwritten locals are not counted as free
+	while ((p < limit) && (*p == STACK_CANARY)) p++;
+	
+	// An ISR may have lowered the mark during the scan, keep the lower one
+	sreg = SREG;
+	cli();
+	if (p < stack_lowest) stack_lowest = p;
+	used = (unsigned char*)RAMEND + 1 - stack_lowest;
+	SREG = sreg;
+	
+	return used;
+}
+
+/**********************************
+Function name	:	stack_free
+Functionality	:	To get the RAM never reached by the stack, as of the last stack_high_water()
+Arguments		:	None
+Return Value	:	Free RAM between the static data and the high-water mark (bytes)
+Example Call	:	stack_free()
+***********************************/
+unsigned int stack_free()
+{
+	unsigned char sreg = SREG;
+	unsigned int bytes = 0;
+	
+	cli();
+	bytes = stack_lowest - &__heap_start;
+	SREG = sreg;
+	
+	return bytes;
+}
+
+/**********************************
+Function name	:	stack_static
+Functionality	:	To get the RAM used by the static data (.data, .bss and .noinit)
+Arguments		:	None
+Return Value	:	Static data (bytes)
+Example Call	:	stack_static()
+***********************************/
+unsigned int stack_static()
+{
+	return &__heap_start - (unsigned char*)RAMSTART;
+}
+
+#ifdef STACK_PROFILE
+/**********************************
+Function name	:	stack_isr_begin
+Functionality	:	To paint STACK_ISR_WINDOW bytes below the stack of an ISR
+Arguments		:	None
+Return Value	:	None
+Example Call	:	stack_isr_begin()
+***********************************/
+void stack_isr_begin()
+{
+	unsigned char *p = 0;
+	
+	isr_body = (unsigned char*)(uintptr_t)SP;
+	isr_window = isr_body - STACK_ISR_WINDOW;
+	if (isr_window < &__heap_start) isr_window = &__heap_start;
+	
+	// Keep the high-water mark of the code which ran below here before
+	p = isr_window;
+	while ((p < isr_body) && (*p == STACK_CANARY)) p++;
+	if (p < stack_lowest) stack_lowest = p;
+	
+	// The top bytes are left for the frame of stack_isr_end()
+	for (p = isr_window; p < isr_body - 8; p++) *p = STACK_CANARY;
+}
+
+/**********************************
+Function name	:	stack_isr_end
+Functionality	:	To record the stack used by an ISR below its body (the registers
+					pushed on entry are not included) since stack_isr_begin()
+Arguments		:	ISR (STACK_ISR_*)
+Return Value	:	None
+Example Call	:	stack_isr_end(STACK_ISR_TILT)
+***********************************/
+void stack_isr_end(unsigned char isr)
+{
+	unsigned char *p = isr_window;
+	unsigned int depth = 0;
+	
+	while ((p < isr_body) && (*p == STACK_CANARY)) p++;
+	depth = isr_body - p;
+	if (depth > isr_depth[isr]) isr_depth[isr] = depth;
+	
+	// The stack may have reached below the lowest byte of the high-water scan
+	if (p < stack_lowest) stack_lowest = p;
+}
+
+/**********************************
+Function name	:	stack_isr_depth
+Functionality	:	Returns the most stack an ISR body has used
+Arguments		:	ISR (STACK_ISR_*)
+Return Value	:	Stack used (bytes)
+Example Call	:	stack_isr_depth(STACK_ISR_TILT)
+***********************************/
+unsigned int stack_isr_depth(unsigned char isr)
+{
+	return isr_depth[isr];
+}
+#endif
\ No newline at end of file
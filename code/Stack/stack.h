@@ -0,0 +1,118 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: stack.h
+*
+* Created: 19-Oct-26 4:47:48 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for measuring the stack use against the 8KB SRAM. The free RAM between the
+* static data and the stack is painted at start-up, the lowest overwritten byte is the
+* high-water mark of the stack. STACK_PROFILE also measures the stack used by each ISR.
+* Tools/ram_budget.cpp checks the static data plus the worst case stack at build time.
+*/
+
+#ifndef STACK_H_
+#define STACK_H_
+
+// Uncomment to measure the stack used by every ISR (sent with the stack telemetry)
+// Each instrumented ISR paints and scans STACK_ISR_WINDOW bytes, about 150us per interrupt
+//#define STACK_PROFILE
+
+#define SRAM_SIZE			8192		// Internal SRAM of the ATmega2560 (bytes)
+#define RAM_BUDGET			7168		// Static data plus worst case stack allowed (bytes),
+										// the rest is kept for the bare-metal Serial buffers and logging
+#define STACK_CANARY		0xC5		// Paint byte, unlikely as data or a return address
+#define STACK_ISR_WINDOW	192			// Bytes painted below an ISR (deeper than any ISR)
+
+// Instrumented ISRs, in the order of the stack telemetry packet. Only the ISRs which call
+// functions, a leaf ISR just pushes the registers it uses (counted by Tools/ram_budget.cpp)
+#define STACK_ISR_TILT		0			// Timer 3, GY80 reads and filters
+#define STACK_ISR_RPM		1			// Timer 1, wheel RPM
+#define STACK_ISR_TONE		2			// Timer 4 compare B, RTTTL player
+#define STACK_ISR_ENCODER	3			// Both encoder channels
+#define STACK_ISR_COUNT		4
+
+// Call at the start and the end of an ISR body, nothing without STACK_PROFILE
+#ifdef STACK_PROFILE
+#define STACK_ISR_BEGIN()		stack_isr_begin()
+#define STACK_ISR_END(isr)		stack_isr_end(isr)
+#else
+#define STACK_ISR_BEGIN()
+#define STACK_ISR_END(isr)
+#endif
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	stack_paint
+Functionality	:	To fill the free RAM below the stack with STACK_CANARY, called first
+					in setup() with interrupts still disabled
+Arguments		:	None
+Return Value	:	None
+Example Call	:	stack_paint()
+***********************************/
+void stack_paint();
+
+/**********************************
+Function name	:	stack_high_water
+Functionality	:	To find the deepest the stack has been since stack_paint(). Scans the
+					free RAM from the bottom (about 2ms), call it from the telemetry task
+Arguments		:	None
+Return Value	:	Stack used (bytes below RAMEND)
+Example Call	:	stack_high_water()
+***********************************/
+unsigned int stack_high_water();
+
+/**********************************
+Function name	:	stack_free
+Functionality	:	To get the RAM never reached by the stack, as of the last stack_high_water()
+Arguments		:	None
+Return Value	:	Free RAM between the static data and the high-water mark (bytes)
+Example Call	:	stack_free()
+***********************************/
+unsigned int stack_free();
+
+/**********************************
+Function name	:	stack_static
+Functionality	:	To get the RAM used by the static data (.data, .bss and .noinit)
+Arguments		:	None
+Return Value	:	Static data (bytes)
+Example Call	:	stack_static()
+***********************************/
+unsigned int stack_static();
+
+#ifdef STACK_PROFILE
+/**********************************
+Function name	:	stack_isr_begin
+Functionality	:	To paint STACK_ISR_WINDOW bytes below the stack of an ISR
+Arguments		:	None
+Return Value	:	None
+Example Call	:	stack_isr_begin()
+***********************************/
+void stack_isr_begin();
+
+/**********************************
+Function name	:	stack_isr_end
+Functionality	:	To record the stack used by an ISR below its body (the registers
+					pushed on entry are not included) since stack_isr_begin()
+Arguments		:	ISR (STACK_ISR_*)
+Return Value	:	None
+Example Call	:	stack_isr_end(STACK_ISR_TILT)
+***********************************/
+void stack_isr_end(unsigned char isr);
+
+/**********************************
+Function name	:	stack_isr_depth
+Functionality	:	Returns the most stack an ISR body has used
+Arguments		:	ISR (STACK_ISR_*)
+Return Value	:	Stack used (bytes)
+Example Call	:	stack_isr_depth(STACK_ISR_TILT)
+***********************************/
+unsigned int stack_isr_depth(unsigned char isr);
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: state.cpp
+*
+* Created: 19-Oct-26 4:21:50 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for sharing the sensor state between the ISRs and the control loop
+* The ISRs write shared_state and bump a sequence counter, the control loop copies
+* the whole structure once per tick and retries if an ISR ran during the copy
+*
+* Functions: state_publish, state_snapshot
+*
+* Global Variables: shared_state, state_sequence
+*/
+
+#include "state.h"
+
+// Compiler barrier, keeps the structure accesses on their side of the counter access
+#define STATE_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+// Written only by ISRs, which do not nest, so there is a single writer at a time
+RobotState shared_state = {0, 0, 0, 0, 0, 0, 0, 0};
+
+// Single byte, read and written atomically
+volatile unsigned char state_sequence = 0;
+
+/**********************************
+Function name	:	state_publish
+Functionality	:	To mark the writes made to shared_state as complete, only called
+					from ISRs after the fields have been updated
+Arguments		:	None
+Return Value	:	None
+Example Call	:	state_publish()
+***********************************/
+void state_publish()
+{
+	STATE_BARRIER();
+	state_sequence++;
+}
+
+/**********************************
+Function name	:	state_snapshot
+Functionality	:	To take a consistent copy of shared_state without disabling interrupts
+Arguments		:	Destination structure
+Return Value	:	None
+Example Call	:	state_snapshot(&robot)
+***********************************/
+void state_snapshot(RobotState *snapshot)
+{
+	unsigned char sequence = 0;
+	
+	// An ISR can only publish between the two counter reads, copy again if one did
+	do
+	{
+		sequence = state_sequence;
+		STATE_BARRIER();
+		*snapshot = shared_state;
+		STATE_BARRIER();
+	} while (sequence != state_sequence);
+}
\ No newline at end of file
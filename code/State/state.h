@@ -0,0 +1,60 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: state.h
+*
+* Created: 19-Oct-26 4:21:50 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for sharing the sensor state between the ISRs and the control loop
+* The ISRs write shared_state and bump a sequence counter, the control loop copies
+* the whole structure once per tick and retries if an ISR ran during the copy
+*/
+
+#ifndef STATE_H_
+#define STATE_H_
+
+// Structure to hold the sensor state measured by the ISRs
+typedef struct RobotState
+{
+	// Timer 3 (100Hz)
+	float tilt_angle;		// Fused pitch angle (deg)
+	float gyro_angle;		// Gyroscope pitch angle (deg)
+	float accel_angle;		// Accelerometer pitch angle (deg)
+	float yaw_angle;		// Fused heading (deg)
+	float yaw_rate;			// Z-axis angular velocity (DPS)
+	
+	// Timer 1 (50Hz)
+	float left_RPM;			// Left motor RPM
+	float right_RPM;		// Right motor RPM
+	float encoder_count;	// Sum of both encoder counts at the RPM sample
+};
+
+extern RobotState shared_state;
+extern volatile unsigned char state_sequence;
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	state_publish
+Functionality	:	To mark the writes made to shared_state as complete, only called
+					from ISRs after the fields have been updated
+Arguments		:	None
+Return Value	:	None
+Example Call	:	state_publish()
+***********************************/
+void state_publish();
+
+/**********************************
+Function name	:	state_snapshot
+Functionality	:	To take a consistent copy of shared_state without disabling interrupts
+Arguments		:	Destination structure
+Return Value	:	None
+Example Call	:	state_snapshot(&robot)
+***********************************/
+void state_snapshot(RobotState *snapshot);
+
+#endif
\ No newline at end of file
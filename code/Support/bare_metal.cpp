@@ -0,0 +1,221 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: bare_metal.cpp
+*
+* Created: 19-Oct-26 4:24:07 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Replacements for the parts of the Arduino core used by the robot
+*
+* Functions: BareSerial::begin, BareSerial::available, BareSerial::read, BareSerial::write,
+* BareSerial::print, ISR(USART0_RX_vect), ISR(USART0_UDRE_vect), main
+*
+* Global Variables: Serial, rx_buffer, tx_buffer, rx_head, rx_tail, tx_head, tx_tail
+*/
+
+#include "platform.h"
+
+#ifdef BARE_METAL
+
+BareSerial Serial;
+
+// Ring buffers, the head is written by the producer and the tail by the consumer
+unsigned char rx_buffer[SERIAL_RX_SIZE];
+unsigned char tx_buffer[SERIAL_TX_SIZE];
+volatile unsigned char rx_head = 0, rx_tail = 0;
+volatile unsigned char tx_head = 0, tx_tail = 0;
+
+// Sketch entry points
+void setup();
+void loop();
+
+/**********************************
+Function name	:	BareSerial::begin
+Functionality	:	To initialise USART0 for 8N1 at the given baud rate
+Arguments		:	Baud rate
+Return Value	:	None
+Example Call	:	Serial.begin(9600)
+***********************************/
+void BareSerial::begin(unsigned long baud)
+{
+	unsigned int ubrr = (F_CPU/(8UL*baud)) - 1;	// Double speed mode, exact for 14.7456MHz
+	
+	UCSR0B = 0x00;
+	UBRR0H = ubrr >> 8;
+	UBRR0L = ubrr & 0xFF;
+	UCSR0A = 0x02;		// U2X0
+	UCSR0C = 0x06;		// Asynchronous, 8 data bits, no parity, 1 stop bit
+	UCSR0B = 0x98;		// RX complete interrupt, receiver and transmitter enabled
+}
+
+/**********************************
+Function name	:	BareSerial::available
+Functionality	:	Returns the number of received bytes waiting to be read
+Arguments		:	None
+Return Value	:	Number of bytes
+Example Call	:	Serial.available()
+***********************************/
+int BareSerial::available()
+{
+	return (unsigned char)(rx_head - rx_tail) & (SERIAL_RX_SIZE - 1);
+}
+
+/**********************************
+Function name	:	BareSerial::read
+Functionality	:	To read the next received byte
+Arguments		:	None
+Return Value	:	Byte, -1 if nothing has been received
+Example Call	:	Serial.read()
+***********************************/
+int BareSerial::read()
+{
+	unsigned char data = 0;
+	
+	if (rx_head == rx_tail) return -1;
+	data = rx_buffer[rx_tail];
+	rx_tail = (rx_tail + 1) & (SERIAL_RX_SIZE - 1);
+	return data;
+}
+
+/**********************************
+Function name	:	BareSerial::write
+Functionality	:	To queue a byte for transmission, waits only when the buffer is full
+Arguments		:	Byte
+Return Value	:	None
+Example Call	:	Serial.write(XBEE_START_DELIMITER)
+***********************************/
+void BareSerial::write(unsigned char data)
+{
+	unsigned char next = (tx_head + 1) & (SERIAL_TX_SIZE - 1);
+	
+	// Buffer full, send a byte by polling if the UDRE interrupt cannot run
+	while (next == tx_tail)
+	{
+		if (!(SREG & 0x80) && (UCSR0A & 0x20))
+		{
+			UDR0 = tx_buffer[tx_tail];
+			tx_tail = (tx_tail + 1) & (SERIAL_TX_SIZE - 1);
+		}
+	}
+	
+	tx_buffer[tx_head] = data;
+	tx_head = next;
+	UCSR0B |= 0x20;		// Data register empty interrupt
+}
+
+/**********************************
+Function name	:	BareSerial::print
+Functionality	:	To send text or a number in decimal
+Arguments		:	Text or value (floats with the number of decimal digits)
+Return Value	:	None
+Example Call	:	Serial.print("duty,left_RPM,right_RPM")
+***********************************/
+void BareSerial::print(const char *text)
+{
+	while (*text) write(*text++);
+}
+
+void BareSerial::print(unsigned long value)
+{
+	char digits[10];
+	unsigned char count = 0;
+	
+	do
+	{
+		digits[count++] = '0' + (value % 10);
+		value /= 10;
+	} while (value);
+	
+	while (count) write(digits[--count]);
+}
+
+void BareSerial::print(long value)
+{
+	if (value < 0)
+	{
+		write('-');
+		print((unsigned long)(-value));
+	}
+	else print((unsigned long)value);
+}
+
+void BareSerial::print(double value, int digits)
+{
+	double rounding = 0.5;
+	
+	if (value < 0)
+	{
+		write('-');
+		value = -value;
+	}
+	
+	for (int i=0; i<digits; i++) rounding /= 10.0;
+	value += rounding;
+	
+	print((unsigned long)value);
+	value -= (unsigned long)value;
+	if (digits > 0) write('.');
+	
+	while (digits-- > 0)
+	{
+		value *= 10.0;
+		write('0' + (unsigned char)value);
+		value -= (unsigned char)value;
+	}
+}
+
+/**********************************
+Function name	:	ISR(USART0_RX_vect)
+Functionality	:	ISR to store a received byte, dropped when the buffer is full
+Arguments		:	USART0 receive complete vector
+Return Value	:	None
+Example Call	:	Called automatically
+***********************************/
+ISR(USART0_RX_vect)
+{
+	unsigned char data = UDR0;
+	unsigned char next = (rx_head + 1) & (SERIAL_RX_SIZE - 1);
+	
+	if (next != rx_tail)
+	{
+		rx_buffer[rx_head] = data;
+		rx_head = next;
+	}
+}
+
+/**********************************
+Function name	:	ISR(USART0_UDRE_vect)
+Functionality	:	ISR to send the next queued byte, disables itself when the buffer is empty
+Arguments		:	USART0 data register empty vector
+Return Value	:	None
+Example Call	:	Called automatically
+***********************************/
+ISR(USART0_UDRE_vect)
+{
+	if (tx_head == tx_tail)
+	{
+		UCSR0B &= ~0x20;
+		return;
+	}
+	
+	UDR0 = tx_buffer[tx_tail];
+	tx_tail = (tx_tail + 1) & (SERIAL_TX_SIZE - 1);
+}
+
+/**********************************
+Function name	:	main
+Functionality	:	Program entry, replaces the Arduino core main()
+Arguments		:	None
+Return Value	:	None
+Example Call	:	Called automatically
+***********************************/
+int main()
+{
+	setup();
+	for (;;) loop();
+}
+
+#endif
\ No newline at end of file
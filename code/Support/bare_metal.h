@@ -0,0 +1,173 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: bare_metal.h
+*
+* Created: 19-Oct-26 4:24:07 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Replacements for the parts of the Arduino core used by the robot, enabled by
+* BARE_METAL in platform.h. Only what the project uses is provided:
+* Serial (USART0, XBee), pinMode, digitalWrite/digitalRead (constant pins),
+* map, constrain, abs, PI and main(). The encoder interrupts are bound directly
+* to INT2/INT4 in motors.cpp instead of attachInterrupt().
+*
+* Removed with the core:
+* - Timer 0 overflow ISR (millis), 900 times a second at 14.7456MHz and the
+*   jitter it adds to every other interrupt. epoch() already runs on Timer 4
+* - init() setting up every timer for analogWrite(), the timers are configured
+*   by timers.cpp anyway
+* - HardwareSerial 64 byte RX and TX buffers, replaced by 32 and 64 bytes
+* - Pin lookup tables in flash for digitalWrite/pinMode/attachInterrupt
+*
+* Comparison: build the sketch with and without BARE_METAL and compare the
+* avr-size -C --mcu=atmega2560 output (Program and Data), and the interrupt
+* latency with MOTOR_BENCHMARK/epoch_ticks() timestamps on the encoder edges
+*/
+
+#ifndef BARE_METAL_H_
+#define BARE_METAL_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <math.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#ifndef F_CPU
+#define F_CPU 14745600L
+#endif
+
+// USART0 Buffers (power of 2)
+#define SERIAL_RX_SIZE		32
+#define SERIAL_TX_SIZE		64
+
+// Arduino constants
+#define HIGH				0x1
+#define LOW					0x0
+#define INPUT				0x0
+#define OUTPUT				0x1
+#define INPUT_PULLUP		0x2
+#define CHANGE				1
+#define PI					3.1415926535897932384626433832795
+
+// Analog pins of the Arduino Mega
+#define A0	54
+#define A1	55
+#define A2	56
+#define A3	57
+#define A4	58
+#define A5	59
+#define A6	60
+#define A7	61
+#define A8	62
+#define A9	63
+#define A10	64
+#define A11	65
+#define A12	66
+#define A13	67
+#define A14	68
+#define A15	69
+
+// Same definitions as the Arduino core, abs() works on floats
+#undef abs
+#define abs(x) ((x)>0?(x):-(x))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) (bitvalue ? bitSet(value, bit) : bitClear(value, bit))
+
+// Port register lookup for pin numbers
+#include "digitalWriteFast.h"
+
+// USART0 driver with interrupt driven receive and transmit buffers
+class BareSerial
+{
+	public:
+	void begin(unsigned long baud);
+	int available();
+	int read();
+	void write(unsigned char data);
+	
+	void print(const char *text);
+	void print(long value);
+	void print(unsigned long value);
+	void print(int value) {print((long)value);}
+	void print(unsigned int value) {print((unsigned long)value);}
+	void print(double value, int digits=2);
+	
+	void println() {print("\r\n");}
+	template<typename T> void println(T value) {print(value); println();}
+};
+
+extern BareSerial Serial;
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	pinMode
+Functionality	:	To set a pin as output, input or input with pull-up
+Arguments		:	Pin number (constant), Mode
+Return Value	:	None
+Example Call	:	pinMode(ENCA1, INPUT_PULLUP)
+***********************************/
+static inline void pinMode(uint8_t pin, uint8_t mode)
+{
+	uint8_t sreg = SREG;
+	
+	cli();
+	if (mode == OUTPUT) bitSet(*digitalPinToDDRReg(pin), __digitalPinToBit(pin));
+	else
+	{
+		bitClear(*digitalPinToDDRReg(pin), __digitalPinToBit(pin));
+		bitWrite(*digitalPinToPortReg(pin), __digitalPinToBit(pin), mode == INPUT_PULLUP);
+	}
+	SREG = sreg;
+}
+
+/**********************************
+Function name	:	digitalWrite
+Functionality	:	To set the logic level of an output pin, used by digitalWriteFast
+					when the value is not a constant
+Arguments		:	Pin number (constant), Logic value
+Return Value	:	None
+Example Call	:	digitalWrite(LED1_RED, state)
+***********************************/
+static inline void digitalWrite(uint8_t pin, uint8_t value)
+{
+	uint8_t sreg = SREG;
+	
+	cli();
+	bitWrite(*digitalPinToPortReg(pin), __digitalPinToBit(pin), value);
+	SREG = sreg;
+}
+
+/**********************************
+Function name	:	digitalRead
+Functionality	:	To read the logic level of a pin
+Arguments		:	Pin number (constant)
+Return Value	:	Logic value
+Example Call	:	digitalRead(ENCA2)
+***********************************/
+static inline int digitalRead(uint8_t pin)
+{
+	return BIT_READ(*digitalPinToPINReg(pin), __digitalPinToBit(pin));
+}
+
+/**********************************
+Function name	:	map
+Functionality	:	To re-map a number from one range to another (integer maths)
+Arguments		:	Value, Input range, Output range
+Return Value	:	Mapped value
+Example Call	:	map(output, 0, 1023, -100, 100)
+***********************************/
+static inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+	return (x - in_min)*(out_max - out_min)/(in_max - in_min) + out_min;
+}
+
+#endif
\ No newline at end of file
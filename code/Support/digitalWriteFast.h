@@ -4,7 +4,10 @@ by Watterott electronic (www.watterott.com)
 based on http://code.google.com/p/digitalwritefast
 */
 
-#include <Arduino.h>
+#ifndef DIGITALWRITEFAST_H_
+#define DIGITALWRITEFAST_H_
+
+#include "platform.h"
 
 #define BIT_READ(value, bit) (((value) >> (bit)) & 0x01)
 #define BIT_SET(value, bit) ((value) |= (1UL << (bit)))
@@ -163,3 +166,4 @@ do {if (__builtin_constant_p(P) )  __atomicWrite((uint8_t*) __digitalPinToTimer(
 digitalRead((P))
 #endif
 
+#endif
@@ -0,0 +1,27 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: platform.h
+*
+* Created: 19-Oct-26 4:24:07 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Selects the Arduino core or the bare-metal replacements (bare_metal.h)
+* Every file includes this header instead of Arduino.h
+*/
+
+#ifndef PLATFORM_H_
+#define PLATFORM_H_
+
+// Uncomment to build without the Arduino core, see bare_metal.h
+//#define BARE_METAL
+
+#ifdef BARE_METAL
+#include "bare_metal.h"
+#else
+#include <Arduino.h>
+#endif
+
+#endif
\ No newline at end of file
@@ -14,7 +14,7 @@
 * Global Variables: txf
 */
 
-#include <Arduino.h>
+#include "../Support/platform.h"
 #include "../I2C/i2c_lib.h"
 #include "../Indicators/indicators.h"
 
@@ -0,0 +1,135 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: sysid.cpp
+*
+* Created: 19-Oct-26 4:10:45 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for system identification excitation and data streaming
+*
+* Functions: sysid_excitation, sysid_log, sysid_done, pack_int
+*
+* Global Variables: sysid_tick, prbs_register, prbs_level, chirp_phase,
+* chirp_frequency, sysid_packet, sysid_samples
+*/
+
+#include "../Support/platform.h"
+#include "../Controller/controller.h"
+#include "sysid.h"
+
+// Experiment state
+unsigned int sysid_tick = 0;
+unsigned int prbs_register = 0x01FF;		// 9-bit LFSR, x^9 + x^5 + 1
+float prbs_level = SYSID_AMPLITUDE;
+float chirp_phase = 0;
+float chirp_frequency = SYSID_CHIRP_START;
+
+// Telemetry packet being filled
+unsigned char sysid_packet[3 + 2*SYSID_SAMPLE_SIZE];
+unsigned char sysid_samples = 0;
+
+/**********************************
+Function name	:	sysid_excitation
+Functionality	:	To compute the excitation for the current control tick and advance the experiment
+Arguments		:	None
+Return Value	:	Excitation (PWM), includes SYSID_OFFSET in wheel PWM mode
+Example Call	:	sysid_excitation()
+***********************************/
+float sysid_excitation()
+{
+	float excitation=0;
+	unsigned int tick = sysid_tick;
+	
+	#if SYSID_TARGET == SYSID_WHEEL_PWM
+	float offset = SYSID_OFFSET;
+	#else
+	float offset = 0;
+	#endif
+	
+	// Hold the operating point before and stop after the experiment
+	if (tick < SYSID_DELAY)
+	{
+		sysid_tick++;
+		return offset;
+	}
+	if (sysid_done()) return 0;
+	
+	tick -= SYSID_DELAY;
+	sysid_tick++;
+	
+	#if SYSID_SIGNAL == SYSID_STEP
+	excitation = SYSID_AMPLITUDE;
+	
+	#elif SYSID_SIGNAL == SYSID_PRBS
+	// Shift the LFSR once per bit period
+	if ((tick % SYSID_PRBS_HOLD) == 0)
+	{
+		unsigned int feedback = ((prbs_register >> 8) ^ (prbs_register >> 4)) & 0x01;
+		prbs_register = ((prbs_register << 1) | feedback) & 0x01FF;
+		prbs_level = feedback ? SYSID_AMPLITUDE : -SYSID_AMPLITUDE;
+	}
+	excitation = prbs_level;
+	
+	#elif SYSID_SIGNAL == SYSID_CHIRP
+	// Exponential sweep, equal time per decade
+	excitation = SYSID_AMPLITUDE*sin(chirp_phase);
+	chirp_phase += 2*PI*chirp_frequency*SYSID_PERIOD;
+	if (chirp_phase > 2*PI) chirp_phase -= 2*PI;
+	chirp_frequency *= pow(SYSID_CHIRP_END/SYSID_CHIRP_START, 1.0/SYSID_DURATION);
+	#endif
+	
+	return (offset + excitation);
+}
+
+/**********************************
+Function name	:	pack_int
+Functionality	:	To store a scaled value as a big endian signed 16-bit integer
+Arguments		:	Destination, Value, Scale factor
+Return Value	:	None
+Example Call	:	pack_int(&sysid_packet[3], angle, 100)
+***********************************/
+void pack_int(unsigned char *data, float value, float scale)
+{
+	int scaled = constrain(value*scale, -32768.0, 32767.0);
+	
+	data[0] = (unsigned int)scaled >> 8;
+	data[1] = scaled & 0xFF;
+}
+
+/**********************************
+Function name	:	sysid_log
+Functionality	:	To buffer the synchronised input and response of one control tick,
+					a telemetry frame is sent for every two ticks
+Arguments		:	Excitation, Motor command, Tilt angle, Left RPM, Right RPM
+Return Value	:	None
+Example Call	:	sysid_log(excitation, command, robot.tilt_angle, robot.left_RPM, robot.right_RPM)
+***********************************/
+void sysid_log(float excitation, float command, float angle, float left, float right)
+{
+	unsigned char *sample = &sysid_packet[3 + sysid_samples*SYSID_SAMPLE_SIZE];
+	
+	// Header with the tick of the first sample, the host uses it to detect lost frames
+	if (sysid_samples == 0)
+	{
+		sysid_packet[0] = TELEMETRY_SYSID;
+		sysid_packet[1] = (sysid_tick - 1) >> 8;
+		sysid_packet[2] = (sysid_tick - 1) & 0xFF;
+	}
+	
+	pack_int(&sample[0], excitation, 100);
+	pack_int(&sample[2], command, 100);
+	pack_int(&sample[4], angle, 100);
+	pack_int(&sample[6], left, 10);
+	pack_int(&sample[8], right, 10);
+	
+	if (++sysid_samples < 2) return;
+	
+	sysid_samples = 0;
+	xbee_send_data(sysid_packet, sizeof(sysid_packet));
+}
+
+// Getter function
+bool sysid_done() {return (sysid_tick >= (SYSID_DELAY + SYSID_DURATION));}
\ No newline at end of file
@@ -0,0 +1,78 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: sysid.h
+*
+* Created: 19-Oct-26 4:10:45 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for system identification excitation and data streaming
+*/
+
+#ifndef SYSID_H_
+#define SYSID_H_
+
+// Uncomment to run the system identification experiment instead of normal driving
+// The log is streamed as telemetry frames and fitted with Tools/sysid_fit.cpp
+//#define SYSID_MODE
+
+// Excitation Targets
+#define SYSID_ANGLE_OUTPUT	0		// Added to angle.output, robot balancing
+#define SYSID_WHEEL_PWM		1		// Replaces the motor command, robot held with wheels free
+
+// Excitation Signals
+#define SYSID_STEP			0
+#define SYSID_PRBS			1
+#define SYSID_CHIRP			2
+
+// Experiment Parameters
+#define SYSID_TARGET		SYSID_WHEEL_PWM
+#define SYSID_SIGNAL		SYSID_CHIRP
+#define SYSID_AMPLITUDE		60			// Excitation amplitude (PWM)
+#define SYSID_OFFSET		100			// Operating point in wheel PWM mode (PWM)
+#define SYSID_PERIOD		0.02		// Control loop period (s)
+#define SYSID_DELAY			50			// Quiet ticks before the excitation starts
+#define SYSID_DURATION		3000		// Excitation length (ticks)
+#define SYSID_PRBS_HOLD		2			// Ticks per PRBS bit
+#define SYSID_CHIRP_START	0.1			// Chirp start frequency (Hz)
+#define SYSID_CHIRP_END		10.0		// Chirp end frequency (Hz)
+
+// Telemetry packet ID: tick (2 bytes), then 2 samples of excitation, command,
+// angle (x100) and left/right RPM (x10) as signed 16-bit values
+#define TELEMETRY_SYSID		0x02
+#define SYSID_SAMPLE_SIZE	10
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	sysid_excitation
+Functionality	:	To compute the excitation for the current control tick and advance the experiment
+Arguments		:	None
+Return Value	:	Excitation (PWM), includes SYSID_OFFSET in wheel PWM mode
+Example Call	:	sysid_excitation()
+***********************************/
+float sysid_excitation();
+
+/**********************************
+Function name	:	sysid_log
+Functionality	:	To buffer the synchronised input and response of one control tick,
+					a telemetry frame is sent for every two ticks
+Arguments		:	Excitation, Motor command, Tilt angle, Left RPM, Right RPM
+Return Value	:	None
+Example Call	:	sysid_log(excitation, command, robot.tilt_angle, robot.left_RPM, robot.right_RPM)
+***********************************/
+void sysid_log(float excitation, float command, float angle, float left, float right);
+
+/**********************************
+Function name	:	sysid_done
+Functionality	:	Returns the state of the experiment
+Arguments		:	None
+Return Value	:	True after the excitation has finished
+Example Call	:	sysid_done()
+***********************************/
+bool sysid_done();
+
+#endif
\ No newline at end of file
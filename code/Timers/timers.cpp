@@ -11,7 +11,7 @@
 * Library for handling Timers
 *
 * Functions: timer1_init(), start_timer1(), timer3_init(), start_timer3(),
-* timer4_init(), start_timer4(), epoch()
+* timer4_init(), start_timer4(), timer5_init(), epoch(), epoch_ticks()
 *
 * Global Variables: time_ms, time_sec
 */
@@ -105,9 +105,9 @@ Example Call	:	timer4_init()
 void timer4_init()
 {
 	TCCR4B = 0x00; 		// Stop Timer
-	TCNT4  = 0xC667;	// 0.0009999593097s (~0.001s)
+	TCNT4  = TIMER4_BOTTOM;	// 0.0009999593097s (~0.001s)
 	OCR4A  = 0x0000; 	// Output Compare Register (OCR) - Not used
-	OCR4B  = 0x0000; 	// Output Compare Register (OCR) - Not used
+	OCR4B  = 0x0000; 	// Output Compare Register (OCR) - Buzzer note timing (player)
 	OCR4C  = 0x0000; 	// Output Compare Register (OCR) - Not used
 	ICR4   = 0x0000; 	// Input Capture Register (ICR)  - Not used
 	TCCR4A = 0x00;
@@ -127,6 +127,30 @@ void start_timer4()
 	TIMSK4 = 0x01;		// Enable Timer Overflow Interrupt
 }
 
+/**********************************
+Function name	:	timer5_init
+Functionality	:	TIMER5 Initialize - Prescaler: None
+					WGM: 10 PWM Phase Correct, TOP=ICR5=0x0170
+					OC5A (PL3) and OC5B (PL4) non-inverting motor PWM outputs
+					Desired value: 20kHz
+					Actual value:  20.035kHz (0.17%)
+Arguments		:	None
+Return Value	:	None
+Example Call	:	timer5_init()
+***********************************/
+void timer5_init()
+{
+	TCCR5B = 0x00; 		// Stop Timer
+	TCNT5  = 0x0000;
+	OCR5A  = 0x0000; 	// Output Compare Register (OCR) - Left motor duty
+	OCR5B  = 0x0000; 	// Output Compare Register (OCR) - Right motor duty
+	OCR5C  = 0x0000; 	// Output Compare Register (OCR) - Not used
+	ICR5   = TIMER5_TOP;// Input Capture Register (ICR)  - PWM TOP
+	TCCR5A = 0xA2;		// COM5A 1-0, COM5B 1-0, WGM51
+	TCCR5C = 0x00;
+	TCCR5B = 0x11;		// WGM53, Prescaler None 0-0-1
+}
+
 /**********************************
 Function name	:	ISR(TIMER4_OVF_vect)
 Functionality	:	ISR for program clock
@@ -136,7 +160,7 @@ Example Call	:	Called automatically
 ***********************************/
 ISR(TIMER4_OVF_vect)
 {
-	TCNT4 = 0xC667;		// Reload counter value
+	TCNT4 = TIMER4_BOTTOM;	// Reload counter value
 	time_ms++;			// Increment ms value
 	
 	if (time_ms>=1000)
@@ -161,4 +185,34 @@ unsigned long epoch()
 	unsigned long elapsed_time;
 	elapsed_time = time_sec*1000 + time_ms;
 	return elapsed_time;
+}
+
+/**********************************
+Function name	:	epoch_ticks
+Functionality	:	To read the program time in Timer 4 ticks (1/14.7456 us) for
+					timestamping events shorter than a millisecond. The value wraps
+					around every ~291s, only differences between timestamps are valid
+Arguments		:	None
+Return Value	:	Current program time in Timer 4 ticks
+Example Call	:	epoch_ticks()
+***********************************/
+unsigned long epoch_ticks()
+{
+	unsigned long elapsed_ms;
+	unsigned int ticks;
+	unsigned char sreg = SREG;
+	
+	cli();
+	elapsed_ms = epoch();
+	ticks = TCNT4;
+	
+	// Counter has overflowed but the ISR has not reloaded it yet
+	if ((TIFR4 & 0x01) && (ticks < TIMER4_BOTTOM))
+	{
+		SREG = sreg;
+		return ((elapsed_ms + 1)*TIMER4_TICKS_PER_MS + ticks);
+	}
+	
+	SREG = sreg;
+	return (elapsed_ms*TIMER4_TICKS_PER_MS + (ticks - TIMER4_BOTTOM));
 }
\ No newline at end of file
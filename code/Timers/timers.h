@@ -14,6 +14,14 @@
 #ifndef TIMERS_H_
 #define TIMERS_H_
 
+// Timer 4 Program Clock
+#define TIMER4_BOTTOM			0xC667		// Reload value for 1ms overflow
+#define TIMER4_TICKS_PER_MS		14745UL		// Ticks from BOTTOM to overflow
+#define TIMER4_TICKS_PER_SEC	14745000UL
+
+// Timer 5 Motor PWM
+#define TIMER5_TOP				0x0170		// 368 steps, 20kHz phase correct PWM
+
 // Function Declarations
 
 /**********************************
@@ -52,6 +60,19 @@ Example Call	:	timer4_init()
 ***********************************/
 void timer4_init();
 
+/**********************************
+Function name	:	timer5_init
+Functionality	:	TIMER5 Initialize - Prescaler: None
+					WGM: 10 PWM Phase Correct, TOP=ICR5=0x0170
+					OC5A (PL3) and OC5B (PL4) non-inverting motor PWM outputs
+					Desired value: 20kHz
+					Actual value:  20.035kHz (0.17%)
+Arguments		:	None
+Return Value	:	None
+Example Call	:	timer5_init()
+***********************************/
+void timer5_init();
+
 /**********************************
 Function name	:	start_timer1
 Functionality	:	Start timer 1
@@ -91,4 +112,15 @@ Example Call	:	epoch()
 ***********************************/
 unsigned long epoch();
 
+/**********************************
+Function name	:	epoch_ticks
+Functionality	:	To read the program time in Timer 4 ticks (1/14.7456 us) for
+					timestamping events shorter than a millisecond. The value wraps
+					around every ~291s, only differences between timestamps are valid
+Arguments		:	None
+Return Value	:	Current program time in Timer 4 ticks
+Example Call	:	epoch_ticks()
+***********************************/
+unsigned long epoch_ticks();
+
 #endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: player.cpp
+*
+* Created: 19-Oct-26 4:18:12 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for interrupt driven RTTTL playback
+* Notes are advanced from the Timer 4 compare B interrupt (1kHz) and the tone is
+* generated by Timer 2 toggling OC2B (PH6, buzzer pin 9) in CTC mode
+* Songs are compiled to packed 16-bit notes in flash by rtttl_compiler.h
+*
+* Functions: tone_start, tone_stop, next_note, ISR(TIMER4_COMPB_vect), player_begin,
+* player_stop, player_playing
+*
+* Global Variables: player, octave_7, letter_semitone
+*/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "../Timers/timers.h"
+#include "../Stack/stack.h"
+#include "binrtttl.h"
+#include "rtttl_compiler.h"
+#include "pitches.h"
+#include "player.h"
+
+using anyrtttl::RTTTL_NOTE;
+using anyrtttl::RTTTL_DEFAULT_VALUE_SECTION;
+
+// Structure Initialization
+RtttlPlayer player = {0, false, 0, 0};
+
+// Semitone of each note letter index of binrtttl.cpp (c, d, e, f, g, a, b)
+const unsigned char letter_semitone[7] PROGMEM = {0, 2, 4, 5, 7, 9, 11};
+
+// Highest octave, lower octaves are found by halving
+const unsigned int octave_7[12] PROGMEM = {NOTE_C7, NOTE_CS7, NOTE_D7, NOTE_DS7, NOTE_E7, NOTE_F7,
+										   NOTE_FS7, NOTE_G7, NOTE_GS7, NOTE_A7, NOTE_AS7, NOTE_B7};
+
+/**********************************
+Function name	:	tone_start
+Functionality	:	To generate a square wave on OC2B with Timer 2
+Arguments		:	Frequency (Hz)
+Return Value	:	None
+Example Call	:	tone_start(2093)
+***********************************/
+void tone_start(unsigned int frequency)
+{
+	// Prescalers selected by CS22:0 = 1 to 7
+	const unsigned int prescaler[7] = {1, 8, 32, 64, 128, 256, 1024};
+	unsigned long half_period = F_CPU/(2UL*frequency);
+	unsigned char clock = 0;
+	
+	// Smallest prescaler that fits the half period in the 8-bit counter
+	while ((clock < 6) && ((half_period/prescaler[clock]) > 256)) clock++;
+	
+	OCR2A = (half_period/prescaler[clock]) - 1;
+	OCR2B = 0;
+	if (TCNT2 > OCR2A) TCNT2 = 0;
+	TCCR2A = 0x12;			// Toggle OC2B on compare match, CTC with OCR2A as TOP
+	TCCR2B = clock + 1;
+}
+
+/**********************************
+Function name	:	tone_stop
+Functionality	:	To stop Timer 2 and release the buzzer pin driven low
+Arguments		:	None
+Return Value	:	None
+Example Call	:	tone_stop()
+***********************************/
+void tone_stop()
+{
+	TCCR2A = 0x00;			// OC2B disconnected, pin follows PORTH
+	TCCR2B = 0x00;			// Timer stopped
+	TONE_PORT &= ~TONE_BIT;
+}
+
+/**********************************
+Function name	:	next_note
+Functionality	:	To decode and start the next packed note of the song, the song
+					is ended at the RTTTL_END marker
+Arguments		:	None
+Return Value	:	None
+Example Call	:	next_note()
+***********************************/
+void next_note()
+{
+	RTTTL_NOTE note;
+	unsigned int duration=0;
+	unsigned char semitone=0, octave=0;
+	
+	note.raw = pgm_read_word(player.song);
+	
+	// End of the song
+	if (note.raw == RTTTL_END)
+	{
+		player_stop();
+		return;
+	}
+	player.song++;
+	
+	// Duration (1 to 32) from its index, dotted notes are 1.5 times longer
+	duration = player.wholenote >> note.durationIdx;
+	if (note.dotted) duration += duration/2;
+	
+	// Pause
+	if (note.noteIdx == 7) tone_stop();
+	
+	else
+	{
+		semitone = pgm_read_byte(&letter_semitone[note.noteIdx]) + note.pound;
+		octave = note.octaveIdx + 4;
+		
+		// B# wraps to the next octave
+		if (semitone == 12)
+		{
+			semitone = 0;
+			if (octave < 7) octave++;
+		}
+		
+		tone_start(pgm_read_word(&octave_7[semitone]) >> (7 - octave));
+	}
+	
+	player.remaining = duration ? duration : 1;
+}
+
+/**********************************
+Function name	:	ISR(TIMER4_COMPB_vect)
+Functionality	:	ISR for note timing, runs once per ms while a song is played
+Arguments		:	Timer 4 compare B vector
+Return Value	:	None
+Example Call	:	Called automatically
+***********************************/
+ISR(TIMER4_COMPB_vect)
+{
+	STACK_ISR_BEGIN();
+	if (--player.remaining == 0) next_note();
+	STACK_ISR_END(STACK_ISR_TONE);
+}
+
+/**********************************
+Function name	:	player_begin
+Functionality	:	To start playing a compiled RTTTL song in the background
+Arguments		:	Song words in flash
+Return Value	:	None
+Example Call	:	player_begin(song_startup.words)
+***********************************/
+void player_begin(const unsigned int *song)
+{
+	unsigned char sreg = SREG;
+	RTTTL_DEFAULT_VALUE_SECTION header;
+	
+	cli();
+	header.raw = pgm_read_word(song);
+	player.song = song + 1;
+	
+	// BPM counts quarter notes
+	player.wholenote = (60000UL/header.bpm)*4;
+	player.playing = true;
+	next_note();
+	
+	// Note timing from the Timer 4 compare match, once per Timer 4 period (1ms)
+	OCR4B = TIMER4_BOTTOM + 1;
+	TIFR4 = 0x04;
+	TIMSK4 |= 0x04;
+	SREG = sreg;
+}
+
+/**********************************
+Function name	:	player_stop
+Functionality	:	To stop the song being played
+Arguments		:	None
+Return Value	:	None
+Example Call	:	player_stop()
+***********************************/
+void player_stop()
+{
+	unsigned char sreg = SREG;
+	
+	cli();
+	TIMSK4 &= ~0x04;
+	tone_stop();
+	player.playing = false;
+	SREG = sreg;
+}
+
+// Getter function
+bool player_playing() {return player.playing;}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: player.h
+*
+* Created: 19-Oct-26 4:18:12 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Library for interrupt driven RTTTL playback
+* Notes are advanced from the Timer 4 compare B interrupt (1kHz) and the tone is
+* generated by Timer 2 toggling OC2B (PH6, buzzer pin 9) in CTC mode
+* Songs are compiled to packed 16-bit notes in flash by rtttl_compiler.h
+*/
+
+#ifndef PLAYER_H_
+#define PLAYER_H_
+
+#ifndef F_CPU
+#define F_CPU 14745600L
+#endif
+
+// Timer 2 Tone Output
+#define TONE_DDR		DDRH
+#define TONE_PORT		PORTH
+#define TONE_BIT		0x40		// PH6 - OC2B
+
+// Structure to hold the state of the RTTTL player
+typedef struct RtttlPlayer
+{
+	const unsigned int *song;			// Next note of the compiled song (flash)
+	volatile bool playing;				// Song in progress
+	volatile unsigned int remaining;	// Time left in the current note (ms)
+	unsigned int wholenote;				// Length of a whole note (ms)
+};
+
+extern RtttlPlayer player;
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	tone_start
+Functionality	:	To generate a square wave on OC2B with Timer 2
+Arguments		:	Frequency (Hz)
+Return Value	:	None
+Example Call	:	tone_start(2093)
+***********************************/
+void tone_start(unsigned int frequency);
+
+/**********************************
+Function name	:	tone_stop
+Functionality	:	To stop Timer 2 and release the buzzer pin driven low
+Arguments		:	None
+Return Value	:	None
+Example Call	:	tone_stop()
+***********************************/
+void tone_stop();
+
+/**********************************
+Function name	:	player_begin
+Functionality	:	To start playing a compiled RTTTL song in the background
+Arguments		:	Song words in flash
+Return Value	:	None
+Example Call	:	player_begin(song_startup.words)
+***********************************/
+void player_begin(const unsigned int *song);
+
+/**********************************
+Function name	:	player_stop
+Functionality	:	To stop the song being played
+Arguments		:	None
+Return Value	:	None
+Example Call	:	player_stop()
+***********************************/
+void player_stop();
+
+/**********************************
+Function name	:	player_playing
+Functionality	:	Returns the state of the player
+Arguments		:	None
+Return Value	:	True while a song is being played
+Example Call	:	player_playing()
+***********************************/
+bool player_playing();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,172 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: rtttl_compiler.h
+*
+* Created: 19-Oct-26 4:20:05 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Compile-time RTTTL compiler
+* Songs are converted from RTTTL text to 16-bit words by the compiler and stored in flash,
+* nothing is parsed at runtime. Word 0 is the RTTTL_DEFAULT_VALUE_SECTION (binrtttl.h),
+* followed by one RTTTL_NOTE per note and an RTTTL_END marker. Defaults are resolved into
+* every note so the player never needs them.
+*
+* Usage: RTTTL_SONG(song_ready, "Ready:d=8,o=6,b=180:16e6,16f6,16g6,8c.7");
+*		 player_begin(song_ready.words);
+*
+* An invalid song (unknown note, duration or octave) fails to compile with an error
+* pointing at rtttl_invalid_song()
+*/
+
+#ifndef RTTTL_COMPILER_H_
+#define RTTTL_COMPILER_H_
+
+#include <avr/pgmspace.h>
+
+// Marker after the last note, real notes always have the padding bits clear
+#define RTTTL_END				0xFFFF
+
+// Header defaults from the RTTTL specification
+#define RTTTL_DEFAULT_DURATION	4
+#define RTTTL_DEFAULT_OCTAVE	6
+#define RTTTL_DEFAULT_BPM		63
+
+// Define a compiled song in flash
+#define RTTTL_SONG(name, song) \
+	constexpr RtttlSong<rtttl_count(song) + 2> name PROGMEM = rtttl_build(song, rtttl_make_sequence<rtttl_count(song)>())
+
+// Compiled song, header + notes + end marker
+template<unsigned int N> struct RtttlSong
+{
+	unsigned int words[N];
+};
+
+// Note indices used to expand one entry per note
+template<unsigned int... I> struct rtttl_sequence {};
+template<unsigned int N, unsigned int... I> struct rtttl_make_sequence : rtttl_make_sequence<N - 1, N - 1, I...> {};
+template<unsigned int... I> struct rtttl_make_sequence<0, I...> : rtttl_sequence<I...> {};
+
+// Not constexpr and never defined, reaching it during compilation is an error
+unsigned int rtttl_invalid_song();
+
+
+// Text helpers
+
+constexpr bool rtttl_is_digit(char c) {return (c >= '0') && (c <= '9');}
+constexpr const char *rtttl_skip(const char *s, char c) {return s + (*s == c);}
+constexpr const char *rtttl_skip_number(const char *s) {return rtttl_is_digit(*s) ? rtttl_skip_number(s + 1) : s;}
+
+constexpr unsigned int rtttl_number(const char *s, unsigned int value)
+{
+	return rtttl_is_digit(*s) ? rtttl_number(s + 1, value*10 + (*s - '0')) : value;
+}
+
+// Position after the next occurrence of c, or the end of the text
+constexpr const char *rtttl_after(const char *s, char c)
+{
+	return (*s == '\0') ? s : ((*s == c) ? s + 1 : rtttl_after(s + 1, c));
+}
+
+
+// Header section (name:d=N,o=N,b=NNN:)
+
+constexpr const char *rtttl_notes(const char *song) {return rtttl_after(rtttl_after(song, ':'), ':');}
+
+constexpr unsigned int rtttl_setting(const char *s, char key, unsigned int fallback)
+{
+	return ((*s == ':') || (*s == '\0')) ? fallback :
+		   (((*s == key) && (s[1] == '=')) ? rtttl_number(s + 2, 0) : rtttl_setting(s + 1, key, fallback));
+}
+
+constexpr unsigned int rtttl_duration(const char *song) {return rtttl_setting(rtttl_after(song, ':'), 'd', RTTTL_DEFAULT_DURATION);}
+constexpr unsigned int rtttl_octave(const char *song) {return rtttl_setting(rtttl_after(song, ':'), 'o', RTTTL_DEFAULT_OCTAVE);}
+constexpr unsigned int rtttl_bpm(const char *song) {return rtttl_setting(rtttl_after(song, ':'), 'b', RTTTL_DEFAULT_BPM);}
+
+
+// Index tables of binrtttl.cpp
+
+constexpr unsigned int rtttl_duration_index(unsigned int value)
+{
+	return (value == 1) ? 0 : (value == 2) ? 1 : (value == 4) ? 2 : (value == 8) ? 3 :
+		   (value == 16) ? 4 : (value == 32) ? 5 : rtttl_invalid_song();
+}
+
+constexpr unsigned int rtttl_letter_index(char letter)
+{
+	return (letter == 'c') ? 0 : (letter == 'd') ? 1 : (letter == 'e') ? 2 : (letter == 'f') ? 3 :
+		   (letter == 'g') ? 4 : (letter == 'a') ? 5 : (letter == 'b') ? 6 : (letter == 'p') ? 7 : rtttl_invalid_song();
+}
+
+constexpr unsigned int rtttl_octave_index(unsigned int value)
+{
+	return ((value >= 4) && (value <= 7)) ? value - 4 : rtttl_invalid_song();
+}
+
+
+// Note encoding, [duration][letter][#][.][octave][.]
+
+constexpr unsigned int rtttl_pack(unsigned int duration, unsigned int letter, bool pound, bool dotted, unsigned int octave)
+{
+	return duration | (letter << 3) | ((unsigned int)pound << 6) | ((unsigned int)dotted << 7) | (octave << 8);
+}
+
+constexpr unsigned int rtttl_encode_end(const char *s, unsigned int note)
+{
+	return ((*s == ',') || (*s == '\0')) ? note : rtttl_invalid_song();
+}
+
+// s: after the sharp, dot: after the first dot, end: after the octave digit
+constexpr unsigned int rtttl_encode_octave(const char *s, const char *dot, const char *end,
+										   unsigned int duration, unsigned int letter, bool pound, unsigned int octave)
+{
+	return rtttl_encode_end(rtttl_skip(end, '.'),
+							rtttl_pack(duration, letter, pound, (dot != s) || (*end == '.'),
+									   rtttl_octave_index(rtttl_is_digit(*dot) ? (unsigned int)(*dot - '0') : octave)));
+}
+
+constexpr unsigned int rtttl_encode_dot(const char *s, unsigned int duration, unsigned int letter, bool pound, unsigned int octave)
+{
+	return rtttl_encode_octave(s, rtttl_skip(s, '.'), rtttl_skip(s, '.') + rtttl_is_digit(*rtttl_skip(s, '.')),
+							   duration, letter, pound, octave);
+}
+
+constexpr unsigned int rtttl_encode_letter(const char *s, unsigned int duration, unsigned int octave)
+{
+	return rtttl_encode_dot(rtttl_skip(s + 1, '#'), duration, rtttl_letter_index(*s), s[1] == '#', octave);
+}
+
+constexpr unsigned int rtttl_encode(const char *s, unsigned int duration, unsigned int octave)
+{
+	return rtttl_encode_letter(rtttl_skip_number(s), rtttl_duration_index(rtttl_is_digit(*s) ? rtttl_number(s, 0) : duration), octave);
+}
+
+
+// Song encoding
+
+constexpr unsigned int rtttl_count_notes(const char *s) {return (*s == '\0') ? 0 : 1 + rtttl_count_notes(rtttl_after(s, ','));}
+constexpr unsigned int rtttl_count(const char *song) {return rtttl_count_notes(rtttl_notes(song));}
+constexpr const char *rtttl_nth(const char *s, unsigned int n) {return n ? rtttl_nth(rtttl_after(s, ','), n - 1) : s;}
+
+// RTTTL_DEFAULT_VALUE_SECTION, duration index, octave index and BPM (1 to 900)
+constexpr unsigned int rtttl_header(const char *song)
+{
+	return ((rtttl_bpm(song) >= 1) && (rtttl_bpm(song) <= 900)) ?
+		   (rtttl_duration_index(rtttl_duration(song)) | (rtttl_octave_index(rtttl_octave(song)) << 3) | (rtttl_bpm(song) << 5)) :
+		   rtttl_invalid_song();
+}
+
+constexpr unsigned int rtttl_note(const char *song, unsigned int n)
+{
+	return rtttl_encode(rtttl_nth(rtttl_notes(song), n), rtttl_duration(song), rtttl_octave(song));
+}
+
+template<unsigned int... I>
+constexpr RtttlSong<sizeof...(I) + 2> rtttl_build(const char *song, rtttl_sequence<I...>)
+{
+	return {{rtttl_header(song), rtttl_note(song, I)..., RTTTL_END}};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,315 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: batch_plant.cpp
+*
+* Created: 19-Oct-26 4:39:17 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Batched plant model of the simulator
+*
+* Functions: batch_init, batch_free, batch_copy, batch_difference, batch_step, batch_step_scalar, batch_step_avx2,
+* batch_avx2, plant_kernel, poly_sin, poly_cos, poly_tanh, lanes_load, lanes_store, lanes_set
+*
+* The step is written once as a template on the lane type, a double for the scalar loop
+* and a GCC vector of four doubles for AVX2, so both paths run the same maths. sin, cos
+* and tanh are polynomials which the compiler can vectorise, accurate to 1e-7 within
+* the +-90 deg pitch range of the model.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "batch_plant.h"
+
+#define BATCH_FIELDS		16			// Arrays in the batch
+#define BATCH_STATE_FIELDS	8			// State and accelerations, the first arrays
+
+// The lane helpers are always inlined into the AVX2 step, no vector crosses a call
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+typedef double Lanes __attribute__((vector_size(BATCH_WIDTH*sizeof(double))));
+
+/**********************************
+Function name	:	lanes_load, lanes_store, lanes_set
+Functionality	:	To move robots between the arrays and the lanes, and to fill the lanes
+					with a constant
+Arguments		:	Array (from the first robot of the lanes), Lanes / Value
+Return Value	:	Lanes
+Example Call	:	lanes_load<Lanes>(&plant->pitch[i])
+***********************************/
+template<typename T> __attribute__((always_inline)) inline T lanes_load(const double *data);
+template<> __attribute__((always_inline)) inline double lanes_load<double>(const double *data) {return *data;}
+template<> __attribute__((always_inline)) inline Lanes lanes_load<Lanes>(const double *data)
+{
+	Lanes value;
+	memcpy(&value, data, sizeof(Lanes));
+	return value;
+}
+
+template<typename T> __attribute__((always_inline)) inline void lanes_store(double *data, T value) {memcpy(data, &value, sizeof(T));}
+
+template<typename T> __attribute__((always_inline)) inline T lanes_set(double value);
+template<> __attribute__((always_inline)) inline double lanes_set<double>(double value) {return value;}
+template<> __attribute__((always_inline)) inline Lanes lanes_set<Lanes>(double value) {return Lanes{value, value, value, value};}
+
+/**********************************
+Function name	:	poly_sin, poly_cos
+Functionality	:	Taylor series of sin and cos to the 11th and 12th power, the angle is
+					limited to +-pi/2
+Arguments		:	Angle (rad)
+Return Value	:	sin/cos of the angle
+Example Call	:	poly_sin(pitch)
+***********************************/
+template<typename T> __attribute__((always_inline)) inline T poly_limit(T x)
+{
+	const T limit = lanes_set<T>(M_PI/2), neg_limit = lanes_set<T>(-M_PI/2);
+	x = (x > limit) ? limit : x;
+	return (x < neg_limit) ? neg_limit : x;
+}
+
+template<typename T> __attribute__((always_inline)) inline T poly_sin(T x)
+{
+	x = poly_limit(x);
+	T x2 = x*x;
+	return x*(1 + x2*(-1.0/6 + x2*(1.0/120 + x2*(-1.0/5040 + x2*(1.0/362880 + x2*(-1.0/39916800))))));
+}
+
+template<typename T> __attribute__((always_inline)) inline T poly_cos(T x)
+{
+	x = poly_limit(x);
+	T x2 = x*x;
+	return 1 + x2*(-1.0/2 + x2*(1.0/24 + x2*(-1.0/720 + x2*(1.0/40320 + x2*(-1.0/3628800 + x2*(1.0/479001600))))));
+}
+
+/**********************************
+Function name	:	poly_tanh
+Functionality	:	Pade approximation of tanh, saturated at +-1 beyond +-4.97
+Arguments		:	Value
+Return Value	:	tanh of the value
+Example Call	:	poly_tanh(speed/FRICTION_SPEED)
+***********************************/
+template<typename T> __attribute__((always_inline)) inline T poly_tanh(T x)
+{
+	const T one = lanes_set<T>(1), neg_one = lanes_set<T>(-1);
+	T x2 = x*x;
+	T y = x*(135135 + x2*(17325 + x2*(378 + x2)))/(135135 + x2*(62370 + x2*(3150 + x2*28)));
+	y = (y > one) ? one : y;
+	return (y < neg_one) ? neg_one : y;
+}
+
+/**********************************
+Function name	:	plant_kernel
+Functionality	:	To advance the robots of one lane group by a semi-implicit Euler step
+Arguments		:	Batch, First robot, Time step (s)
+Return Value	:	None
+Example Call	:	plant_kernel<Lanes>(plant, 8, 0.001)
+***********************************/
+template<typename T> __attribute__((always_inline)) inline void plant_kernel(BatchPlant *plant, int i, double dt)
+{
+	const double r = WHEEL_RADIUS, half_track = WHEEL_TRACK/2;
+	const double a = BODY_MASS + 2*(WHEEL_MASS + WHEEL_INERTIA/(r*r));
+	const double b = BODY_MASS*BODY_COM_HEIGHT;
+	const double c = BODY_INERTIA + BODY_MASS*BODY_COM_HEIGHT*BODY_COM_HEIGHT;
+	const double yaw_inertia = BODY_YAW_INERTIA + 2*(WHEEL_MASS + WHEEL_INERTIA/(r*r))*half_track*half_track;
+	const double no_load = MOTOR_NO_LOAD_RPM*2*M_PI/60;
+	
+	T x_dot = lanes_load<T>(&plant->x_dot[i]);
+	T pitch = lanes_load<T>(&plant->pitch[i]);
+	T pitch_dot = lanes_load<T>(&plant->pitch_dot[i]);
+	T yaw_dot = lanes_load<T>(&plant->yaw_dot[i]);
+	T supply = lanes_load<T>(&plant->battery[i])*(1/BATTERY_NOMINAL);
+	T torque[2];
+	
+	// Motor torque at the wheels, speeds relative to the body
+	for (int motor=0; motor<2; motor++)
+	{
+		T speed = (x_dot + (motor ? yaw_dot : -yaw_dot)*half_track)*(1/r) - pitch_dot;
+		T drive = lanes_load<T>(&plant->duty[motor][i])*supply - speed*(1/no_load);
+		T friction = lanes_load<T>(&plant->friction[motor][i])*poly_tanh(speed*(1/FRICTION_SPEED));
+		torque[motor] = lanes_load<T>(&plant->closed[motor][i])*MOTOR_STALL_TORQUE*(drive - friction);
+	}
+	T total = torque[0] + torque[1];
+	
+	// Wheeled inverted pendulum, the motors push the wheels forward and the body back
+	T s = poly_sin(pitch - lanes_load<T>(&plant->balance[i]));
+	T co = poly_cos(pitch);
+	T force = b*poly_sin(pitch)*pitch_dot*pitch_dot + total*(1/r);
+	T moment = (BODY_MASS*GRAVITY*BODY_COM_HEIGHT)*s - total;
+	T det = a*c - (b*b)*co*co;
+	T x_ddot = (c*force - b*co*moment)/det;
+	T pitch_ddot = (a*moment - b*co*force)/det;
+	T yaw_ddot = ((torque[1] - torque[0])*(half_track/r) - YAW_DAMPING*yaw_dot)*(1/yaw_inertia);
+	
+	// Velocities first, then positions with the new velocities
+	x_dot += x_ddot*dt;
+	pitch_dot += pitch_ddot*dt;
+	yaw_dot += yaw_ddot*dt;
+	lanes_store(&plant->x_dot[i], x_dot);
+	lanes_store(&plant->pitch_dot[i], pitch_dot);
+	lanes_store(&plant->yaw_dot[i], yaw_dot);
+	lanes_store(&plant->x[i], lanes_load<T>(&plant->x[i]) + x_dot*dt);
+	lanes_store(&plant->pitch[i], pitch + pitch_dot*dt);
+	lanes_store(&plant->yaw[i], lanes_load<T>(&plant->yaw[i]) + yaw_dot*dt);
+	lanes_store(&plant->x_ddot[i], x_ddot);
+	lanes_store(&plant->pitch_ddot[i], pitch_ddot);
+}
+
+/**********************************
+Function name	:	batch_init
+Functionality	:	To allocate a batch of robots, everything starts at 0 with nominal battery
+Arguments		:	Batch, Number of robots
+Return Value	:	None
+Example Call	:	batch_init(&plant, 1024)
+***********************************/
+void batch_init(BatchPlant *plant, int count)
+{
+	int padded = (count + BATCH_WIDTH - 1)/BATCH_WIDTH*BATCH_WIDTH;
+	size_t size = padded*sizeof(double);
+	double *memory = (double*)aligned_alloc(BATCH_WIDTH*sizeof(double), BATCH_FIELDS*size);
+	double *fields[BATCH_FIELDS];
+	
+	if (!memory) abort();
+	memset(memory, 0, BATCH_FIELDS*size);
+	for (int i=0; i<BATCH_FIELDS; i++) fields[i] = memory + i*padded;
+	
+	// One allocation, x is at its start
+	plant->count = count;
+	plant->x = fields[0];
+	plant->x_dot = fields[1];
+	plant->pitch = fields[2];
+	plant->pitch_dot = fields[3];
+	plant->yaw = fields[4];
+	plant->yaw_dot = fields[5];
+	plant->x_ddot = fields[6];
+	plant->pitch_ddot = fields[7];
+	plant->balance = fields[8];
+	plant->battery = fields[9];
+	plant->friction[0] = fields[10];
+	plant->friction[1] = fields[11];
+	plant->duty[0] = fields[12];
+	plant->duty[1] = fields[13];
+	plant->closed[0] = fields[14];
+	plant->closed[1] = fields[15];
+	
+	for (int i=0; i<padded; i++) plant->battery[i] = BATTERY_NOMINAL;
+}
+
+/**********************************
+Function name	:	batch_free
+Functionality	:	To release the arrays of a batch
+Arguments		:	Batch
+Return Value	:	None
+Example Call	:	batch_free(&plant)
+***********************************/
+void batch_free(BatchPlant *plant)
+{
+	free(plant->x);
+	memset(plant, 0, sizeof(BatchPlant));
+}
+
+/**********************************
+Function name	:	batch_copy
+Functionality	:	To copy the state, parameters and inputs of a batch into another batch
+					of the same size
+Arguments		:	Destination batch, Source batch
+Return Value	:	None
+Example Call	:	batch_copy(&reference, &plant)
+***********************************/
+void batch_copy(BatchPlant *to, const BatchPlant *from)
+{
+	int padded = (from->count + BATCH_WIDTH - 1)/BATCH_WIDTH*BATCH_WIDTH;
+	
+	if (to->count != from->count) abort();
+	memcpy(to->x, from->x, BATCH_FIELDS*padded*sizeof(double));
+}
+
+/**********************************
+Function name	:	batch_difference
+Functionality	:	To compare the state and accelerations of two batches of the same size,
+					relative to the larger value or to 1 for values below 1
+Arguments		:	Batch, Batch
+Return Value	:	Largest relative difference
+Example Call	:	batch_difference(&plant, &reference)
+***********************************/
+double batch_difference(const BatchPlant *a, const BatchPlant *b)
+{
+	int padded = (a->count + BATCH_WIDTH - 1)/BATCH_WIDTH*BATCH_WIDTH;
+	double largest = 0;
+	
+	if (a->count != b->count) abort();
+	for (int field=0; field<BATCH_STATE_FIELDS; field++)
+	{
+		for (int i=0; i<a->count; i++)
+		{
+			double value_a = a->x[field*padded + i], value_b = b->x[field*padded + i];
+			double scale = std::max(std::max(std::fabs(value_a), std::fabs(value_b)), 1.0);
+			
+			largest = std::max(largest, std::fabs(value_a - value_b)/scale);
+		}
+	}
+	return largest;
+}
+
+/**********************************
+Function name	:	batch_step_scalar
+Functionality	:	To advance every robot of a batch by one step, one robot at a time
+Arguments		:	Batch, Time step (s)
+Return Value	:	None
+Example Call	:	batch_step_scalar(&plant, 0.001)
+***********************************/
+void batch_step_scalar(BatchPlant *plant, double dt)
+{
+	for (int i=0; i<plant->count; i++) plant_kernel<double>(plant, i, dt);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**********************************
+Function name	:	batch_step_avx2
+Functionality	:	To advance every robot of a batch by one step, four robots at a time.
+					Must only be called when batch_avx2() is true
+Arguments		:	Batch, Time step (s)
+Return Value	:	None
+Example Call	:	batch_step_avx2(&plant, 0.001)
+***********************************/
+__attribute__((target("avx2,fma"))) void batch_step_avx2(BatchPlant *plant, double dt)
+{
+	// The padding robots are stepped too, they stay at rest
+	for (int i=0; i<plant->count; i+=BATCH_WIDTH) plant_kernel<Lanes>(plant, i, dt);
+}
+
+/**********************************
+Function name	:	batch_avx2
+Functionality	:	To check if the AVX2 step can run on this processor
+Arguments		:	None
+Return Value	:	True if AVX2 and FMA are available
+Example Call	:	batch_avx2()
+***********************************/
+bool batch_avx2()
+{
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#else
+void batch_step_avx2(BatchPlant *plant, double dt) {batch_step_scalar(plant, dt);}
+bool batch_avx2() {return false;}
+#endif
+
+/**********************************
+Function name	:	batch_step
+Functionality	:	To advance every robot of a batch by one semi-implicit Euler step,
+					with AVX2 when the processor has it
+Arguments		:	Batch, Time step (s)
+Return Value	:	None
+Example Call	:	batch_step(&plant, 0.001)
+***********************************/
+void batch_step(BatchPlant *plant, double dt)
+{
+	static const bool avx2 = batch_avx2();
+	
+	// A single robot is faster without the lane shuffling
+	if (avx2 && (plant->count >= BATCH_WIDTH)) batch_step_avx2(plant, dt);
+	else batch_step_scalar(plant, dt);
+}
\ No newline at end of file
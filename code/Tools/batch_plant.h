@@ -0,0 +1,148 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: batch_plant.h
+*
+* Created: 19-Oct-26 4:39:17 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Batched plant model of the simulator. Every field is an array over the robots
+* (struct of arrays), so a step runs four robots per AVX2 instruction, with a
+* scalar loop on machines without AVX2
+*
+* Plant: body pitching about the wheel axle, both wheels rolling without slip, DC motors
+* with back EMF and friction acting between the body and the wheels. The constants are
+* estimates for the robot (1.1kg, 68mm wheels) and can be refined from sysid_fit.
+*/
+
+#ifndef BATCH_PLANT_H_
+#define BATCH_PLANT_H_
+
+#include "../Battery/battery.h"
+#include "../Odometry/odometry.h"
+
+// Plant constants
+#define GRAVITY				9.81
+#define BODY_MASS			1.0			// Body, battery and boards (kg)
+#define BODY_COM_HEIGHT		0.08		// Centre of mass above the axle (m)
+#define BODY_INERTIA		0.004		// Pitch inertia about the centre of mass (kg m^2)
+#define BODY_YAW_INERTIA	0.006		// Yaw inertia of the body (kg m^2)
+#define WHEEL_MASS			0.05		// Each wheel (kg)
+#define WHEEL_INERTIA		0.00012		// Each wheel with the reflected gearbox and rotor (kg m^2)
+#define WHEEL_RADIUS		(WHEEL_DIAMETER*0.0000005)	// um diameter to m radius
+#define WHEEL_TRACK			(WHEEL_BASE*0.000001)		// m
+#define YAW_DAMPING			0.02		// Tyre scrub while turning (N m s)
+
+// Motor constants at BATTERY_NOMINAL and full duty
+#define MOTOR_STALL_TORQUE	0.35		// At the wheel (N m)
+#define MOTOR_NO_LOAD_RPM	330.0
+#define FRICTION_SPEED		0.5			// Speed below which friction fades out (rad/s)
+
+#define BATCH_WIDTH			4			// Robots per AVX2 register, arrays are padded to a multiple
+#define BATCH_TOLERANCE		1e-12		// Largest relative difference between the AVX2 and scalar steps
+
+// Structure to hold the state, parameters and inputs of a batch of robots
+typedef struct BatchPlant
+{
+	int count;					// Robots
+	
+	// State
+	double *x, *x_dot;			// Axle position (m), forward is positive
+	double *pitch, *pitch_dot;	// Body pitch (rad), leaning forward is positive
+	double *yaw, *yaw_dot;		// Heading (rad), turning left is positive
+	
+	// Accelerations of the last step, for the accelerometer
+	double *x_ddot, *pitch_ddot;
+	
+	// Parameters
+	double *balance;			// Pitch at which the centre of mass is above the axle (rad)
+	double *battery;			// Battery voltage (V)
+	double *friction[2];		// Left and right drive friction (fraction of stall torque)
+	
+	// Inputs
+	double *duty[2];			// Left and right bridge voltage (fraction of the battery, -1 to 1)
+	double *closed[2];			// 1 when the bridge drives or brakes the motor, 0 when it coasts
+};
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	batch_init
+Functionality	:	To allocate a batch of robots, everything starts at 0 with nominal battery
+Arguments		:	Batch, Number of robots
+Return Value	:	None
+Example Call	:	batch_init(&plant, 1024)
+***********************************/
+void batch_init(BatchPlant *plant, int count);
+
+/**********************************
+Function name	:	batch_free
+Functionality	:	To release the arrays of a batch
+Arguments		:	Batch
+Return Value	:	None
+Example Call	:	batch_free(&plant)
+***********************************/
+void batch_free(BatchPlant *plant);
+
+/**********************************
+Function name	:	batch_copy
+Functionality	:	To copy the state, parameters and inputs of a batch into another batch
+					of the same size
+Arguments		:	Destination batch, Source batch
+Return Value	:	None
+Example Call	:	batch_copy(&reference, &plant)
+***********************************/
+void batch_copy(BatchPlant *to, const BatchPlant *from);
+
+/**********************************
+Function name	:	batch_difference
+Functionality	:	To compare the state and accelerations of two batches of the same size,
+					relative to the larger value or to 1 for values below 1
+Arguments		:	Batch, Batch
+Return Value	:	Largest relative difference
+Example Call	:	batch_difference(&plant, &reference)
+***********************************/
+double batch_difference(const BatchPlant *a, const BatchPlant *b);
+
+/**********************************
+Function name	:	batch_step
+Functionality	:	To advance every robot of a batch by one semi-implicit Euler step,
+					with AVX2 when the processor has it
+Arguments		:	Batch, Time step (s)
+Return Value	:	None
+Example Call	:	batch_step(&plant, 0.001)
+***********************************/
+void batch_step(BatchPlant *plant, double dt);
+
+/**********************************
+Function name	:	batch_step_scalar
+Functionality	:	To advance every robot of a batch by one step, one robot at a time
+Arguments		:	Batch, Time step (s)
+Return Value	:	None
+Example Call	:	batch_step_scalar(&plant, 0.001)
+***********************************/
+void batch_step_scalar(BatchPlant *plant, double dt);
+
+/**********************************
+Function name	:	batch_step_avx2
+Functionality	:	To advance every robot of a batch by one step, four robots at a time.
+					Must only be called when batch_avx2() is true
+Arguments		:	Batch, Time step (s)
+Return Value	:	None
+Example Call	:	batch_step_avx2(&plant, 0.001)
+***********************************/
+void batch_step_avx2(BatchPlant *plant, double dt);
+
+/**********************************
+Function name	:	batch_avx2
+Functionality	:	To check if the AVX2 step can run on this processor
+Arguments		:	None
+Return Value	:	True if AVX2 and FMA are available
+Example Call	:	batch_avx2()
+***********************************/
+bool batch_avx2();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,173 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: benchmark.cpp
+*
+* Created: 19-Oct-26 4:26:04 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host micro-benchmarks of the control loop kernels, built from the firmware sources
+* with the register stand-ins in Tools/host (bare-metal configuration, no Arduino core)
+*
+* Build (from code/Tools):
+*   g++ -std=gnu++17 -O2 -DBARE_METAL -Ihost -o benchmark benchmark.cpp batch_plant.cpp \
+*       $(find .. -name '*.cpp' -not -path '*Tools*' -not -name bare_metal.cpp)
+* Usage: ./benchmark [kernel name filter]
+*
+* Every kernel runs over a fixed table of inputs and the time per call is reported in ns.
+* The host numbers are for comparing changes, not absolute AVR timing. For cycle counts
+* time the same calls on the robot with epoch_ticks() (Timer 4 counts CPU cycles),
+* the way benchmark_motor_PWM() does. Post the before/after table with every change
+* made for performance.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "../Support/platform.h"
+#include "../I2C/i2c_lib.h"
+#include "../Accelerometer/accel.h"
+#include "../Gyroscope/gyro.h"
+#include "../Controller/controller.h"
+#include "../Motors/motors.h"
+#include "../Indicators/indicators.h"
+#include "../State/state.h"
+#include "../Tones/rtttl_compiler.h"
+#include "../Tones/player.h"
+#include "batch_plant.h"
+
+#define INPUT_COUNT		64			// Inputs per table, cycled through by the kernels
+#define RUN_TIME		0.2			// Measuring time per kernel (s)
+#define BATCH_ROBOTS	1024		// Robots per simulator batch step
+
+// Firmware functions and variables without a module header (Balance_Bot_2403.cpp, player.cpp)
+float complimentary_filter(float angle1, float angle2, float alpha);
+void compute_angle_PID();
+void compute_velocity_PID();
+void compute_encoder_PID();
+void compute_rotation_PID();
+void next_note();
+extern RobotState robot;
+extern volatile unsigned long int time_ms;
+
+RTTTL_SONG(song_benchmark, "MissionImp:d=16,o=7,b=95:g,8p,g,8p,a#,p,c7,p,g,8p,g,8p,f,p,f#,p,a#,g,2d,32p,a#,g,2c#,32p,a#,g,2c,a#5,8c,2p,32p,a#5,g5,2f#,32p,a#5,g5,2f");
+
+// Fixed inputs
+float angles[INPUT_COUNT];
+float rates[INPUT_COUNT];
+unsigned int raw_values[INPUT_COUNT];
+
+// Simulator plant, a balancing spread of robots under random drive
+BatchPlant plant;
+
+// Results are summed here so that no call can be optimised away
+volatile float sink = 0;
+
+// Serial of the bare-metal build, the firmware prints to stdout
+BareSerial Serial;
+void BareSerial::begin(unsigned long baud) {}
+int BareSerial::available() {return 0;}
+int BareSerial::read() {return -1;}
+void BareSerial::write(unsigned char data) {putchar(data);}
+void BareSerial::print(const char *text) {fputs(text, stdout);}
+void BareSerial::print(long value) {printf("%ld", value);}
+void BareSerial::print(unsigned long value) {printf("%lu", value);}
+void BareSerial::print(double value, int digits) {printf("%.*f", digits, value);}
+
+/**********************************
+Function name	:	make_inputs
+Functionality	:	To fill the input tables with a repeatable spread of values
+Arguments		:	None
+Return Value	:	None
+Example Call	:	make_inputs()
+***********************************/
+void make_inputs()
+{
+	unsigned int seed = 2403;
+	
+	for (int i=0; i<INPUT_COUNT; i++)
+	{
+		seed = seed*1103515245 + 12345;
+		angles[i] = ((seed >> 16) % 2000)/100.0 - 10.0;		// -10 to 10 deg
+		rates[i] = ((seed >> 8) % 4000)/10.0 - 200.0;		// -200 to 200 DPS
+		raw_values[i] = seed >> 16;							// Full 16-bit range
+	}
+	
+	batch_init(&plant, BATCH_ROBOTS);
+	for (int i=0; i<BATCH_ROBOTS; i++)
+	{
+		plant.pitch[i] = angles[i % INPUT_COUNT]*0.001;
+		plant.friction[0][i] = plant.friction[1][i] = 0.13;
+		plant.duty[0][i] = angles[i % INPUT_COUNT]*0.05;
+		plant.duty[1][i] = angles[(i + 1) % INPUT_COUNT]*0.05;
+		plant.closed[0][i] = plant.closed[1][i] = 1;
+	}
+}
+
+/**********************************
+Function name	:	run
+Functionality	:	To time a kernel and print the time per call
+Arguments		:	Kernel name, Name filter, Kernel (called with the input index)
+Return Value	:	None
+Example Call	:	run("convert_gyro", filter, [](int i) {...})
+***********************************/
+template<typename Kernel> void run(const char *name, const char *filter, Kernel kernel)
+{
+	typedef std::chrono::steady_clock Clock;
+	unsigned long calls = 0, batch = 1024;
+	double elapsed = 0;
+	
+	if (filter && !strstr(name, filter)) return;
+	
+	// Warm up, then run batches until the measuring time has passed
+	for (unsigned long i=0; i<batch; i++) kernel(i % INPUT_COUNT);
+	
+	Clock::time_point begin = Clock::now();
+	while (elapsed < RUN_TIME)
+	{
+		for (unsigned long i=0; i<batch; i++) kernel(i % INPUT_COUNT);
+		calls += batch;
+		elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+	}
+	
+	printf("%-26s %10.2f ns/op\n", name, elapsed*1e9/calls);
+}
+
+int main(int argc, char **argv)
+{
+	const char *filter = (argc > 1) ? argv[1] : NULL;
+	
+	make_inputs();
+	time_ms = 10000;		// Well after start-up
+	set_ready_state(true);	// Start-up calibration done, so compute_rotation_PID() holds the heading
+	player_begin(song_benchmark.words);
+	
+	printf("%-26s %13s\n", "kernel", "time");
+	
+	// Sensor fusion and conversion
+	run("complimentary_filter", filter, [](int i) {sink += complimentary_filter(angles[i], angles[INPUT_COUNT-1-i], 0.98);});
+	run("convert_gyro", filter, [](int i) {sink += convert_gyro(raw_values[i], 0.93170);});
+	run("convert_accelerometer", filter, [](int i) {sink += convert_accelerometer(raw_values[i]);});
+	run("accel_pitch", filter, [](int i) {sink += accel_pitch(angles[i]*0.05, 1.0);});
+	
+	// Controllers, fed through the state snapshot
+	run("compute_angle_PID", filter, [](int i) {robot.tilt_angle = angles[i]; compute_angle_PID();});
+	run("compute_velocity_PID", filter, [](int i) {robot.left_RPM = rates[i]; robot.right_RPM = rates[INPUT_COUNT-1-i]; compute_velocity_PID();});
+	run("compute_encoder_PID", filter, [](int i) {robot.encoder_count = raw_values[i]; compute_encoder_PID();});
+	run("compute_rotation_PID", filter, [](int i) {robot.yaw_angle = angles[i]*10; robot.yaw_rate = rates[i]; compute_rotation_PID();});
+	
+	// Joystick and motor output
+	run("get_joystick_zone", filter, [](int i) {sink += get_joystick_zone(raw_values[i] & 0xFF, (raw_values[i] >> 8) & 0x03, 9);});
+	run("drive_motor", filter, [](int i) {drive_motor(LEFT, angles[i]*25);});
+	
+	// RTTTL note decode, restarts at the first note when the song ends
+	run("next_note", filter, [](int i) {if (!player_playing()) player_begin(song_benchmark.words); else next_note();});
+	
+	// Simulator plant, one step of the whole batch per call
+	run("batch_step scalar x1024", filter, [](int i) {batch_step_scalar(&plant, 0.001);});
+	if (batch_avx2()) run("batch_step avx2 x1024", filter, [](int i) {batch_step_avx2(&plant, 0.001);});
+	
+	return 0;
+}
\ No newline at end of file
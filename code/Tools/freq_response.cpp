@@ -0,0 +1,251 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: freq_response.cpp
+*
+* Created: 19-Oct-26 4:42:07 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host frequency response of the PID loops. Each loop of the cascade (angle, velocity,
+* encoder, rotation) is broken at the measurement its controller reads: a sine is added
+* there while the robot balances in the simulator, with the firmware compute_PID() closing
+* all the loops. The open loop response -response/(response + sine) is measured over a
+* sweep of frequencies, and the gain and phase margins, the delay margin and the closed
+* loop bandwidth are reported
+*
+* Build (from code/Tools):
+*   g++ -std=gnu++17 -O2 -DBARE_METAL -Ihost -o freq_response freq_response.cpp simulator.cpp batch_plant.cpp \
+*       $(find .. -name '*.cpp' -not -path '*Tools*' -not -name bare_metal.cpp -not -name Balance_Bot_2403.cpp)
+* Usage: ./freq_response [-l angle|velocity|encoder|rotation] [-f min Hz] [-F max Hz] [-n points] [-a amplitude scale] [-j processes]
+*
+* The robot runs the nominal scenario of sim_defaults() without noise, the motor friction
+* makes the loops non-linear, so the response is that at the injected amplitude (-a). The
+* delay margin is the extra latency the loop tolerates at its gain crossover, compare it
+* with the 20ms PID period. The angle loop has an unstable plant, so it needs a gain
+* margin both ways: a negative margin is the gain reduction at which it falls.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "simulator.h"
+
+#define LOOP_COUNT			4
+#define TRANSIENT_PERIODS	3			// Sine periods before the measurement
+#define TRANSIENT_MIN		2.0			// (s)
+#define MEASURE_PERIODS		10			// Sine periods measured
+#define MEASURE_MIN			20.0		// (s)
+#define BANDWIDTH_LEVEL		-3.0		// Closed loop gain at the bandwidth (dB)
+
+typedef std::complex<double> Complex;
+
+// Structure to hold the sine injected into a loop
+typedef struct LoopSpec
+{
+	const char *name;
+	const char *signal;		// Measurement broken
+	int loop;				// SIM_LOOP_*
+	float amplitude;		// In the unit of the measurement
+	const char *unit;
+};
+
+LoopSpec loops[LOOP_COUNT] = {
+	{"angle", "tilt angle", SIM_LOOP_ANGLE, 0.5, "deg"},
+	{"velocity", "wheel speed", SIM_LOOP_VELOCITY, 10, "RPM"},
+	{"encoder", "encoder count", SIM_LOOP_ENCODER, 100, "counts"},
+	{"rotation", "heading", SIM_LOOP_ROTATION, 3, "deg"}
+};
+
+/**********************************
+Function name	:	decibels
+Functionality	:	To convert a gain to dB
+Arguments		:	Gain
+Return Value	:	Gain (dB)
+Example Call	:	decibels(abs(response))
+***********************************/
+double decibels(double gain)
+{
+	return 20*log10(gain);
+}
+
+/**********************************
+Function name	:	wrap_phase
+Functionality	:	To wrap a phase to -180 to 180 deg
+Arguments		:	Phase (deg)
+Return Value	:	Wrapped phase (deg)
+Example Call	:	wrap_phase(190)
+***********************************/
+double wrap_phase(double phase)
+{
+	return phase - 360*floor((phase + 180)/360);
+}
+
+/**********************************
+Function name	:	crossing
+Functionality	:	To interpolate the frequency and the response at which a quantity crosses
+					zero between two sweep points, linear in the logarithm of the frequency
+Arguments		:	Frequencies (Hz), Open loop responses, Quantity at both points,
+					Frequency at the crossing (Hz), Response at the crossing
+Return Value	:	None
+Example Call	:	crossing(f1, f2, L1, L2, q1, q2, &frequency, &response)
+***********************************/
+void crossing(double f1, double f2, Complex L1, Complex L2, double q1, double q2, double *frequency, Complex *response)
+{
+	double t = q1/(q1 - q2);
+	
+	*frequency = f1*pow(f2/f1, t);
+	*response = L1 + t*(L2 - L1);
+}
+
+/**********************************
+Function name	:	report_loop
+Functionality	:	To print the open loop response of a loop with its margins and bandwidth
+Arguments		:	Loop, Frequencies (Hz), Results of the sweep
+Return Value	:	None
+Example Call	:	report_loop(&loops[0], frequencies, &results[0])
+***********************************/
+void report_loop(const LoopSpec *spec, const std::vector<double> &frequencies, const SimResult *results)
+{
+	int points = frequencies.size(), last = -1;
+	double frequency=0, margin=0, closed=0, last_closed=0;
+	bool bandwidth=false;
+	std::vector<Complex> L(points);
+	Complex response;
+	
+	printf("\n%s loop, sine on the %s (%.4g %s)\n", spec->name, spec->signal, spec->amplitude, spec->unit);
+	printf("%10s %10s %10s %10s\n", "Hz", "|L| dB", "phase deg", "|T| dB");
+	for (int i=0; i<points; i++)
+	{
+		Complex y(results[i].loop_response[0], results[i].loop_response[1]);
+		Complex d(results[i].loop_injection[0], results[i].loop_injection[1]);
+		
+		if (results[i].fallen)
+		{
+			printf("%10.3f %10s\n", frequencies[i], "fell");
+			continue;
+		}
+		L[i] = -y/(y + d);
+		printf("%10.3f %10.2f %10.1f %10.2f\n", frequencies[i], decibels(abs(L[i])), arg(L[i])*180/M_PI, decibels(abs(L[i]/(1.0 + L[i]))));
+	}
+	
+	// Margins between neighbouring points which both stayed up
+	for (int i=0; i<points; i++)
+	{
+		if (results[i].fallen) continue;
+		if (last < 0)
+		{
+			last = i;
+			last_closed = decibels(abs(L[i]/(1.0 + L[i])));
+			if (last_closed < BANDWIDTH_LEVEL) printf("bandwidth below %.3f Hz\n", frequencies[i]);
+			else bandwidth = true;
+			continue;
+		}
+		
+		// Gain crossover, |L| = 1
+		if ((abs(L[last]) >= 1) != (abs(L[i]) >= 1))
+		{
+			crossing(frequencies[last], frequencies[i], L[last], L[i], decibels(abs(L[last])), decibels(abs(L[i])), &frequency, &response);
+			margin = wrap_phase(arg(response)*180/M_PI + 180);
+			printf("gain crossover  %7.3f Hz   phase margin %6.1f deg", frequency, margin);
+			if (margin > 0) printf("   delay margin %6.1f ms", 1000*margin/(360*frequency));
+			printf("\n");
+		}
+		
+		// Phase crossover, L on the negative real axis
+		if ((L[last].imag() >= 0) != (L[i].imag() >= 0))
+		{
+			crossing(frequencies[last], frequencies[i], L[last], L[i], L[last].imag(), L[i].imag(), &frequency, &response);
+			if (response.real() < 0) printf("phase crossover %7.3f Hz   gain margin  %6.1f dB\n", frequency, -decibels(-response.real()));
+		}
+		
+		// Closed loop bandwidth, the first drop through BANDWIDTH_LEVEL
+		closed = decibels(abs(L[i]/(1.0 + L[i])));
+		if (bandwidth && (closed < BANDWIDTH_LEVEL))
+		{
+			crossing(frequencies[last], frequencies[i], L[last], L[i], last_closed - BANDWIDTH_LEVEL, closed - BANDWIDTH_LEVEL, &frequency, &response);
+			printf("bandwidth       %7.3f Hz\n", frequency);
+			bandwidth = false;
+		}
+		last_closed = closed;
+		last = i;
+	}
+	if (bandwidth) printf("bandwidth above %.3f Hz\n", frequencies[last]);
+}
+
+int main(int argc, char **argv)
+{
+	int points = 30, jobs = std::thread::hardware_concurrency(), option = 0, selected = -1;
+	double min_frequency = 0.1, max_frequency = 10, scale = 1;
+	std::vector<int> sweep;
+	
+	while ((option = getopt(argc, argv, "l:f:F:n:a:j:")) != -1)
+	{
+		switch (option)
+		{
+			case 'l':
+				for (int i=0; i<LOOP_COUNT; i++) if (!strcmp(optarg, loops[i].name)) selected = i;
+				if (selected >= 0) break;
+				fprintf(stderr, "Unknown loop %s\n", optarg);
+				return 1;
+			case 'f': min_frequency = atof(optarg); break;
+			case 'F': max_frequency = atof(optarg); break;
+			case 'n': points = atoi(optarg); break;
+			case 'a': scale = atof(optarg); break;
+			case 'j': jobs = atoi(optarg); break;
+			default:
+				fprintf(stderr, "Usage: %s [-l angle|velocity|encoder|rotation] [-f min Hz] [-F max Hz] [-n points] [-a amplitude scale] [-j processes]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (points < 2) points = 2;
+	if (jobs < 1) jobs = 1;
+	if ((min_frequency <= 0) || (max_frequency <= min_frequency))
+	{
+		fprintf(stderr, "Frequencies must be 0 < min < max\n");
+		return 1;
+	}
+	
+	// Log spaced sweep
+	std::vector<double> frequencies(points);
+	for (int i=0; i<points; i++) frequencies[i] = min_frequency*pow(max_frequency/min_frequency, (double)i/(points - 1));
+	
+	for (int i=0; i<LOOP_COUNT; i++)
+	{
+		if ((selected < 0) || (selected == i)) sweep.push_back(i);
+		loops[i].amplitude *= scale;
+	}
+	
+	// One scenario per loop and frequency, whole periods after the transient
+	std::vector<SimParams> params(sweep.size()*points);
+	std::vector<SimResult> results(params.size());
+	for (size_t loop=0; loop<sweep.size(); loop++)
+	{
+		for (int i=0; i<points; i++)
+		{
+			SimParams *scenario = &params[loop*points + i];
+			double period = 1/frequencies[i];
+			
+			sim_defaults(scenario);
+			scenario->loop = loops[sweep[loop]].loop;
+			scenario->loop_amplitude = loops[sweep[loop]].amplitude;
+			scenario->loop_frequency = frequencies[i];
+			scenario->loop_measure = SIM_SETTLE_TIME + ceil(std::max(TRANSIENT_PERIODS*period, TRANSIENT_MIN)/period)*period;
+			scenario->duration = scenario->loop_measure + ceil(std::max(MEASURE_PERIODS*period, MEASURE_MIN)/period)*period;
+		}
+	}
+	
+	printf("%d loops, %d frequencies from %.3g to %.3g Hz on %d processes, PID period 20 ms\n", (int)sweep.size(), points, min_frequency, max_frequency, jobs);
+	sim_batch(params.data(), results.data(), params.size(), jobs);
+	
+	for (size_t loop=0; loop<sweep.size(); loop++) report_loop(&loops[sweep[loop]], frequencies, &results[loop*points]);
+	
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: gain_map.cpp
+*
+* Created: 19-Oct-26 5:07:30 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host stability map of the angle PID loop. Every cell of a grid of KP and KD scales
+* (applied to the conservative and the aggressive gains of pid_gains.h) is one robot of
+* a single batch_plant.h batch, so the whole grid is advanced by one batch_step() per
+* millisecond, four robots per AVX2 instruction
+*
+* Build (from code/Tools):
+*   g++ -std=gnu++17 -O2 -Ihost -o gain_map gain_map.cpp batch_plant.cpp ../PID/pid.cpp
+* Usage: ./gain_map [-n cells per axis] [-l min scale] [-m max scale] [-t initial tilt deg]
+*                   [-d duration s] [-s] [-c]
+*
+* Each robot runs pid_angle_update() of the firmware at 50Hz on the tilt sampled at 100Hz,
+* with the minimum duty of motor_lut.h added as an offset. The sensor filter, the velocity
+* and encoder loops and the battery compensation are left out, so the map is optimistic:
+* use it to see how far the gains are from the edge of the stable region, then check a
+* change with montecarlo. The scales are spaced logarithmically, the map fails when it
+* has no cell on one side of the edge.
+* -s runs the scalar step for comparing the time with the AVX2 step.
+* -c runs the scalar step beside the AVX2 step from the same state every millisecond and
+* fails when they differ by more than BATCH_TOLERANCE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+#include "../PID/pid.h"
+#include "../pid_gains.h"
+#include "batch_plant.h"
+#include "simulator.h"
+
+#define SIM_STEP			0.001		// Physics step (s)
+#define RAD_TO_DEG			(180.0/M_PI)
+#define SENSOR_PERIOD		10			// Tilt sample (steps)
+#define PID_PERIOD			20			// Angle PID (steps)
+#define MIN_DUTY			0.13		// Minimum duty of motor_lut.h
+#define RMS_STEP			0.25		// Tilt RMS per digit of the map (deg)
+
+/**********************************
+Function name	:	grid_scale
+Functionality	:	To get the gain scale of a grid cell, logarithmically spaced
+Arguments		:	Cell, Cells per axis, Smallest scale, Largest scale
+Return Value	:	Gain scale
+Example Call	:	grid_scale(j, cells, 0.05, 4)
+***********************************/
+double grid_scale(int cell, int cells, double min_scale, double max_scale)
+{
+	return min_scale*pow(max_scale/min_scale, (double)cell/(cells - 1));
+}
+
+/**********************************
+Function name	:	grid_cell
+Functionality	:	To find the grid cell closest to a gain scale
+Arguments		:	Gain scale, Cells per axis, Smallest scale, Largest scale
+Return Value	:	Cell, -1 when the scale is outside the grid
+Example Call	:	grid_cell(1.0, cells, 0.05, 4)
+***********************************/
+int grid_cell(double scale, int cells, double min_scale, double max_scale)
+{
+	double cell = log(scale/min_scale)/log(max_scale/min_scale)*(cells - 1);
+	
+	if ((cell < -0.5) || (cell >= cells - 0.5)) return -1;
+	return std::lround(cell);
+}
+
+int main(int argc, char **argv)
+{
+	int cells = 30, option = 0, count = 0, nominal_kp = 0, nominal_kd = 0, standing = 0;
+	double min_scale = 0.05, max_scale = 4, tilt = 5, duration = 5, difference = 0;
+	bool scalar = false, check = false;
+	const float gains[6] = {ANGLE_GAINS};
+	BatchPlant plant, reference;
+	
+	while ((option = getopt(argc, argv, "n:l:m:t:d:sc")) != -1)
+	{
+		switch (option)
+		{
+			case 'n': cells = atoi(optarg); break;
+			case 'l': min_scale = atof(optarg); break;
+			case 'm': max_scale = atof(optarg); break;
+			case 't': tilt = atof(optarg); break;
+			case 'd': duration = atof(optarg); break;
+			case 's': scalar = true; break;
+			case 'c': check = true; break;
+			default:
+				fprintf(stderr, "Usage: %s [-n cells per axis] [-l min scale] [-m max scale] [-t initial tilt deg] [-d duration s] [-s] [-c]\n", argv[0]);
+				return 1;
+		}
+	}
+	if ((cells < 2) || (min_scale <= 0) || (max_scale <= min_scale) || (duration <= 0))
+	{
+		fprintf(stderr, "Need at least 2 cells, 0 < min scale < max scale and a positive duration\n");
+		return 1;
+	}
+	if (check && !batch_avx2())
+	{
+		fprintf(stderr, "No AVX2 on this processor, nothing to check\n");
+		return 1;
+	}
+	
+	// Robot i*cells + j has KD scale of cell i and KP scale of cell j
+	count = cells*cells;
+	std::vector<PID> angle(count);
+	std::vector<double> kp(count), kd(count), error_sum(count);
+	std::vector<bool> fallen(count);
+	unsigned long steps = duration/SIM_STEP;
+	
+	batch_init(&plant, count);
+	for (int i=0; i<cells; i++)
+	{
+		for (int j=0; j<cells; j++)
+		{
+			int robot = i*cells + j;
+			
+			kd[robot] = grid_scale(i, cells, min_scale, max_scale);
+			kp[robot] = grid_scale(j, cells, min_scale, max_scale);
+			angle[robot] = {(float)(kp[robot]*gains[0]), gains[1], (float)(kd[robot]*gains[2]),
+			                (float)(kp[robot]*gains[3]), gains[4], (float)(kd[robot]*gains[5])};
+			
+			// The tilt angle of the firmware is positive leaning back
+			plant.pitch[robot] = tilt/RAD_TO_DEG;
+			plant.friction[0][robot] = plant.friction[1][robot] = MIN_DUTY;
+			plant.closed[0][robot] = plant.closed[1][robot] = 1;
+			angle[robot].position = angle[robot].last_position = -tilt;
+		}
+	}
+	nominal_kp = grid_cell(1.0, cells, min_scale, max_scale);
+	nominal_kd = nominal_kp;
+	if (check) batch_init(&reference, count);
+	
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned long step=1; step<=steps; step++)
+	{
+		if (check)
+		{
+			batch_copy(&reference, &plant);
+			batch_step_scalar(&reference, SIM_STEP);
+			batch_step_avx2(&plant, SIM_STEP);
+			difference = std::max(difference, batch_difference(&plant, &reference));
+		}
+		else if (scalar) batch_step_scalar(&plant, SIM_STEP);
+		else batch_step(&plant, SIM_STEP);
+		
+		for (int robot=0; robot<count; robot++)
+		{
+			double lean = plant.pitch[robot]*RAD_TO_DEG;
+			
+			error_sum[robot] += lean*lean;
+			if (fabs(lean) > SIM_FALL_ANGLE) fallen[robot] = true;
+			
+			// A fallen robot lies on the floor
+			if (fallen[robot]) plant.x_dot[robot] = plant.pitch_dot[robot] = plant.yaw_dot[robot] = 0;
+			if (step % SENSOR_PERIOD == 0) angle[robot].position = -lean;
+		}
+		if (step % PID_PERIOD) continue;
+		
+		// compute_angle_PID() with the set-point at the balance point, forward duty recovers a forward lean
+		for (int robot=0; robot<count; robot++)
+		{
+			double output = 0;
+			
+			pid_angle_update(&angle[robot]);
+			output = angle[robot].output/PID_OUTPUT_LIMIT;
+			if (output != 0) output += (output > 0) ? MIN_DUTY : -MIN_DUTY;
+			plant.duty[0][robot] = plant.duty[1][robot] = fallen[robot] ? 0 : std::min(std::max(output, -1.0), 1.0);
+		}
+	}
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	
+	// KD rows from the top, KP columns, '.' fell and digits are the tilt RMS
+	printf("Angle loop, %.3g deg initial tilt for %.3g s, scales of pid_gains.h, nominal at ^ and <\n", tilt, duration);
+	printf("digit = tilt RMS in %.2g deg steps, . = fell\n\n", RMS_STEP);
+	for (int i=cells-1; i>=0; i--)
+	{
+		printf("KD %6.3f  ", kd[i*cells]);
+		for (int j=0; j<cells; j++)
+		{
+			int robot = i*cells + j;
+			int digit = std::min((int)(sqrt(error_sum[robot]/steps)/RMS_STEP), 9);
+			
+			if (fallen[robot]) putchar('.');
+			else
+			{
+				putchar('0' + digit);
+				standing++;
+			}
+		}
+		printf("%s\n", (i == nominal_kd) ? " <" : "");
+	}
+	if (nominal_kp >= 0) printf("           %*s^\n", nominal_kp, "");
+	printf("KP %.3f to %.3f\n\n", kp[0], kp[cells - 1]);
+	printf("%d of %d gain pairs stay up\n", standing, count);
+	printf("%d robots, %.3g s simulated in %.1f ms on the %s step\n", count, duration, elapsed*1000,
+	       check ? "AVX2 and scalar" : ((scalar || !batch_avx2()) ? "scalar" : "AVX2"));
+	
+	batch_free(&plant);
+	if (check)
+	{
+		batch_free(&reference);
+		printf("AVX2 against scalar step: %.2g largest relative difference, tolerance %.2g\n", difference, BATCH_TOLERANCE);
+		if (difference > BATCH_TOLERANCE) return 1;
+	}
+	
+	// A map without both sides of the edge says nothing about the margin
+	if ((standing == 0) || (standing == count))
+	{
+		fprintf(stderr, "No %s cells, widen the scale range with -l and -m\n", standing ? "unstable" : "stable");
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
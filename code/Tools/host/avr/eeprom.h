@@ -0,0 +1,26 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: eeprom.h
+*
+* Created: 19-Oct-26 4:54:13 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host stand-in for <avr/eeprom.h>, an EEMEM variable is ordinary memory and holds
+* its own EEPROM contents (zero, not erased, at start)
+*/
+
+#ifndef HOST_AVR_EEPROM_H_
+#define HOST_AVR_EEPROM_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#define EEMEM
+
+inline void eeprom_read_block(void *destination, const void *source, size_t size) {memcpy(destination, source, size);}
+inline void eeprom_update_block(const void *source, void *destination, size_t size) {memcpy(destination, source, size);}
+
+#endif
\ No newline at end of file
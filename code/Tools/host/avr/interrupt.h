@@ -0,0 +1,25 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: interrupt.h
+*
+* Created: 19-Oct-26 4:26:04 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host stand-in for <avr/interrupt.h>, ISRs become plain functions which the host
+* tools can call
+*/
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define ISR(vector, ...) extern "C" void vector(void)
+
+inline void cli() {}
+inline void sei() {}
+
+#endif
\ No newline at end of file
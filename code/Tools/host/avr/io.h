@@ -0,0 +1,162 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: io.h
+*
+* Created: 19-Oct-26 4:26:04 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host stand-in for <avr/io.h>, used to build the firmware sources into the host tools.
+* Registers are plain variables and the I2C status bits never change, so only code which
+* does not wait on the hardware can be run
+*/
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+#define __AVR_ATmega2560__
+#define F_CPU 14745600L
+#define RAMSTART 0x0200
+#define RAMEND 0x21FF
+#define _BV(bit) (1 << (bit))
+
+// TWI bits (i2c_lib.h)
+#define TWINT	7
+#define TWEA	6
+#define TWSTA	5
+#define TWSTO	4
+#define TWEN	2
+#define TWIE	0
+
+// Registers
+inline volatile uint8_t PORTA;
+inline volatile uint8_t DDRA;
+inline volatile uint8_t PINA;
+inline volatile uint8_t PORTB;
+inline volatile uint8_t DDRB;
+inline volatile uint8_t PINB;
+inline volatile uint8_t PORTC;
+inline volatile uint8_t DDRC;
+inline volatile uint8_t PINC;
+inline volatile uint8_t PORTD;
+inline volatile uint8_t DDRD;
+inline volatile uint8_t PIND;
+inline volatile uint8_t PORTE;
+inline volatile uint8_t DDRE;
+inline volatile uint8_t PINE;
+inline volatile uint8_t PORTF;
+inline volatile uint8_t DDRF;
+inline volatile uint8_t PINF;
+inline volatile uint8_t PORTG;
+inline volatile uint8_t DDRG;
+inline volatile uint8_t PING;
+inline volatile uint8_t PORTH;
+inline volatile uint8_t DDRH;
+inline volatile uint8_t PINH;
+inline volatile uint8_t PORTJ;
+inline volatile uint8_t DDRJ;
+inline volatile uint8_t PINJ;
+inline volatile uint8_t PORTK;
+inline volatile uint8_t DDRK;
+inline volatile uint8_t PINK;
+inline volatile uint8_t PORTL;
+inline volatile uint8_t DDRL;
+inline volatile uint8_t PINL;
+inline volatile uint8_t TCCR0A;
+inline volatile uint8_t TCCR0B;
+inline volatile uint8_t TCCR0C;
+inline volatile uint8_t TIMSK0;
+inline volatile uint8_t TIFR0;
+inline volatile uint8_t TCCR1A;
+inline volatile uint8_t TCCR1B;
+inline volatile uint8_t TCCR1C;
+inline volatile uint8_t TIMSK1;
+inline volatile uint8_t TIFR1;
+inline volatile uint8_t TCCR2A;
+inline volatile uint8_t TCCR2B;
+inline volatile uint8_t TCCR2C;
+inline volatile uint8_t TIMSK2;
+inline volatile uint8_t TIFR2;
+inline volatile uint8_t TCCR3A;
+inline volatile uint8_t TCCR3B;
+inline volatile uint8_t TCCR3C;
+inline volatile uint8_t TIMSK3;
+inline volatile uint8_t TIFR3;
+inline volatile uint8_t TCCR4A;
+inline volatile uint8_t TCCR4B;
+inline volatile uint8_t TCCR4C;
+inline volatile uint8_t TIMSK4;
+inline volatile uint8_t TIFR4;
+inline volatile uint8_t TCCR5A;
+inline volatile uint8_t TCCR5B;
+inline volatile uint8_t TCCR5C;
+inline volatile uint8_t TIMSK5;
+inline volatile uint8_t TIFR5;
+inline volatile uint8_t TCNT0;
+inline volatile uint8_t TCNT2;
+inline volatile uint8_t OCR0A;
+inline volatile uint8_t OCR0B;
+inline volatile uint8_t OCR2A;
+inline volatile uint8_t OCR2B;
+inline volatile uint8_t ASSR;
+inline volatile uint8_t TWSR;
+inline volatile uint8_t TWCR;
+inline volatile uint8_t TWBR;
+inline volatile uint8_t TWDR;
+inline volatile uint8_t EICRA;
+inline volatile uint8_t EICRB;
+inline volatile uint8_t EIMSK;
+inline volatile uint8_t EIFR;
+inline volatile uint8_t ADMUX;
+inline volatile uint8_t ADCSRA;
+inline volatile uint8_t ADCSRB;
+inline volatile uint8_t ADCL;
+inline volatile uint8_t ADCH;
+inline volatile uint8_t DIDR0;
+inline volatile uint8_t DIDR2;
+inline volatile uint8_t SREG;
+inline volatile uint8_t UCSR0A;
+inline volatile uint8_t UCSR0B;
+inline volatile uint8_t UCSR0C;
+inline volatile uint8_t UDR0;
+inline volatile uint8_t UBRR0H;
+inline volatile uint8_t UBRR0L;
+inline volatile uint8_t MCUSR;
+inline volatile uint8_t SPL;
+inline volatile uint8_t SPH;
+inline volatile uint16_t SP;
+inline volatile uint16_t TCNT1;
+inline volatile uint16_t OCR1A;
+inline volatile uint16_t OCR1B;
+inline volatile uint16_t OCR1C;
+inline volatile uint16_t ICR1;
+inline volatile uint16_t TCNT3;
+inline volatile uint16_t OCR3A;
+inline volatile uint16_t OCR3B;
+inline volatile uint16_t OCR3C;
+inline volatile uint16_t ICR3;
+inline volatile uint16_t TCNT4;
+inline volatile uint16_t OCR4A;
+inline volatile uint16_t OCR4B;
+inline volatile uint16_t OCR4C;
+inline volatile uint16_t ICR4;
+inline volatile uint16_t TCNT5;
+inline volatile uint16_t OCR5A;
+inline volatile uint16_t OCR5B;
+inline volatile uint16_t OCR5C;
+inline volatile uint16_t ICR5;
+inline volatile uint16_t ADC;
+
+// Linker symbol at the end of the static data (Stack/stack.cpp)
+inline unsigned char __heap_start;
+
+// Pin access without the constant address casts of digitalWriteFast.h
+#define digitalWriteFast(P, V) digitalWrite((P), (V))
+#define digitalReadFast(P) digitalRead((P))
+#define pinModeFast(P, V) pinMode((P), (V))
+
+#endif
\ No newline at end of file
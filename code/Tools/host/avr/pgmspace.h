@@ -0,0 +1,32 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: pgmspace.h
+*
+* Created: 19-Oct-26 4:26:04 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host stand-in for <avr/pgmspace.h>, flash data is ordinary memory.
+* Words are read as 16 bits like on the AVR (little endian host)
+*/
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) host_read_word(address)
+
+inline uint16_t host_read_word(const void *address)
+{
+	uint16_t value;
+	memcpy(&value, address, sizeof(value));
+	return value;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: delay.h
+*
+* Created: 19-Oct-26 4:26:04 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host stand-in for <util/delay.h>
+*/
+
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+inline void _delay_ms(double) {}
+inline void _delay_us(double) {}
+
+#endif
\ No newline at end of file
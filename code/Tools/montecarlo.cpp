@@ -0,0 +1,157 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: montecarlo.cpp
+*
+* Created: 19-Oct-26 4:32:38 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host Monte Carlo robustness check of the gains in Balance_Bot_2403.h. Runs thousands of
+* simulated scenarios with random sensor noise, gyroscope bias, CG offset, motor friction,
+* battery voltage and joystick commands on all cores, and reports the fall rate, settling
+* time and drift statistics
+*
+* Build (from code/Tools):
+*   g++ -std=gnu++17 -O2 -DBARE_METAL -Ihost -o montecarlo montecarlo.cpp simulator.cpp batch_plant.cpp \
+*       $(find .. -name '*.cpp' -not -path '*Tools*' -not -name bare_metal.cpp -not -name Balance_Bot_2403.cpp)
+* Usage: ./montecarlo [-n scenarios] [-s seed] [-j processes] [-v]
+*
+* Each scenario (sim_random) starts with SIM_SETTLE_TIME of balancing from a random initial
+* tilt, drives a random joystick sequence and ends with SIM_HOLD_TIME of position hold.
+* -v lists the scenarios which fell, run them again with -s seed -n 1.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "simulator.h"
+
+// Scenario parameters shown in the sensitivity table
+#define FACTOR_COUNT		6
+const char *factor_names[FACTOR_COUNT] = {"initial tilt", "CG offset", "gyro bias", "gyro noise", "friction", "battery"};
+
+/**********************************
+Function name	:	factor_value
+Functionality	:	To get a parameter of the sensitivity table from a scenario
+Arguments		:	Scenario parameters, Factor index
+Return Value	:	Magnitude of the parameter
+Example Call	:	factor_value(&params, 1)
+***********************************/
+float factor_value(const SimParams *params, int factor)
+{
+	switch (factor)
+	{
+		case 0: return std::fabs(params->initial_tilt);
+		case 1: return std::fabs(params->cg_offset);
+		case 2: return std::fabs(params->gyro_bias);
+		case 3: return params->gyro_noise;
+		case 4: return std::max(params->deadband[0], params->deadband[1]);
+		default: return -params->battery;	// Low battery is the hard case
+	}
+}
+
+/**********************************
+Function name	:	print_stats
+Functionality	:	To print the mean, median, 95th percentile and maximum of a metric
+Arguments		:	Metric name, Values, Unit
+Return Value	:	None
+Example Call	:	print_stats("drift", drift, "mm")
+***********************************/
+void print_stats(const char *name, std::vector<float> values, const char *unit)
+{
+	double sum = 0;
+	
+	if (values.empty())
+	{
+		printf("%-20s %10s\n", name, "-");
+		return;
+	}
+	
+	std::sort(values.begin(), values.end());
+	for (float value : values) sum += value;
+	printf("%-20s %10.3f %10.3f %10.3f %10.3f  %s\n", name, sum/values.size(), values[values.size()/2],
+	       values[(values.size()*95)/100], values.back(), unit);
+}
+
+int main(int argc, char **argv)
+{
+	int count = 2000, jobs = std::thread::hardware_concurrency(), option = 0;
+	unsigned long seed = 2403;
+	bool verbose = false;
+	
+	while ((option = getopt(argc, argv, "n:s:j:v")) != -1)
+	{
+		switch (option)
+		{
+			case 'n': count = atoi(optarg); break;
+			case 's': seed = strtoul(optarg, NULL, 0); break;
+			case 'j': jobs = atoi(optarg); break;
+			case 'v': verbose = true; break;
+			default:
+				fprintf(stderr, "Usage: %s [-n scenarios] [-s seed] [-j processes] [-v]\n", argv[0]);
+				return 1;
+		}
+	}
+	if (count < 1) count = 1;
+	if (jobs < 1) jobs = 1;
+	
+	std::vector<SimParams> params(count);
+	std::vector<SimResult> results(count);
+	for (int i=0; i<count; i++) sim_random(&params[i], seed + i);
+	
+	printf("%d scenarios on %d processes\n", count, jobs);
+	sim_batch(params.data(), results.data(), count, jobs);
+	
+	// Fall rate and the metrics of the scenarios which did not fall
+	std::vector<float> settling, drift, heading_drift, tilt_RMS, effort;
+	int falls = 0;
+	for (int i=0; i<count; i++)
+	{
+		if (results[i].fallen)
+		{
+			falls++;
+			if (verbose) printf("fell at %6.2fs  seed %lu  tilt %5.1f  cg %5.2f  bias %5.2f  noise %4.2f  friction %4.2f/%4.2f  battery %4.2f\n",
+			                    results[i].fall_time, params[i].seed, params[i].initial_tilt, params[i].cg_offset, params[i].gyro_bias,
+			                    params[i].gyro_noise, params[i].deadband[0], params[i].deadband[1], params[i].battery);
+			continue;
+		}
+		settling.push_back(results[i].settling_time);
+		drift.push_back(results[i].drift);
+		heading_drift.push_back(results[i].heading_drift);
+		tilt_RMS.push_back(results[i].tilt_RMS);
+		effort.push_back(results[i].effort);
+	}
+	
+	printf("\nfall rate            %d/%d (%.2f%%)\n\n", falls, count, 100.0*falls/count);
+	printf("%-20s %10s %10s %10s %10s\n", "metric", "mean", "median", "p95", "max");
+	print_stats("settling time", settling, "s");
+	print_stats("position drift", drift, "mm");
+	print_stats("heading drift", heading_drift, "deg");
+	print_stats("tilt RMS", tilt_RMS, "deg");
+	print_stats("effort", effort, "PWM");
+	
+	// Fall rate in the mildest and the hardest quarter of each parameter
+	printf("\n%-20s %10s %10s\n", "fall rate by", "mildest", "hardest");
+	for (int factor=0; factor<FACTOR_COUNT; factor++)
+	{
+		std::vector<int> order(count);
+		int quarter = std::max(count/4, 1), mild = 0, hard = 0;
+		
+		for (int i=0; i<count; i++) order[i] = i;
+		std::sort(order.begin(), order.end(), [&](int a, int b) {return factor_value(&params[a], factor) < factor_value(&params[b], factor);});
+		for (int i=0; i<quarter; i++)
+		{
+			mild += results[order[i]].fallen;
+			hard += results[order[count-1-i]].fallen;
+		}
+		printf("%-20s %9.2f%% %9.2f%%\n", factor_names[factor], 100.0*mild/quarter, 100.0*hard/quarter);
+	}
+	
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: motor_lut.cpp
+*
+* Created: 19-Oct-26 4:08:40 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host tool to generate Motors/motor_lut.h from the characterise_motors() sweep
+*
+* Build: g++ -O2 -o motor_lut motor_lut.cpp
+* Usage: ./motor_lut < sweep.csv > ../Motors/motor_lut.h
+*
+* Both tables map the command to the duty giving command/255 of the top speed
+* of the slower wheel, so the wheels respond linearly and symmetrically.
+*/
+
+#include <cstdio>
+#include <vector>
+
+// Sweep sample
+struct Sample
+{
+	double duty;
+	double RPM;
+};
+
+/**********************************
+Function name	:	make_monotonic
+Functionality	:	To remove the measurement noise which makes the RPM decrease with duty
+Arguments		:	Sweep samples
+Return Value	:	None
+Example Call	:	make_monotonic(left)
+***********************************/
+void make_monotonic(std::vector<Sample> &samples)
+{
+	for (size_t i=1; i<samples.size(); i++)
+		if (samples[i].RPM < samples[i-1].RPM) samples[i].RPM = samples[i-1].RPM;
+}
+
+/**********************************
+Function name	:	inverse_duty
+Functionality	:	To find the duty for a target RPM by linear interpolation of the sweep
+Arguments		:	Sweep samples, Target RPM
+Return Value	:	Duty (Timer 5 counts)
+Example Call	:	inverse_duty(left, 120.0)
+***********************************/
+double inverse_duty(const std::vector<Sample> &samples, double target)
+{
+	for (size_t i=1; i<samples.size(); i++)
+	{
+		if (samples[i].RPM < target) continue;
+		
+		// Interpolate from the last duty below the target
+		double span = samples[i].RPM - samples[i-1].RPM;
+		if (span <= 0) return samples[i].duty;
+		return samples[i-1].duty + (target - samples[i-1].RPM)*(samples[i].duty - samples[i-1].duty)/span;
+	}
+	
+	return samples.back().duty;
+}
+
+/**********************************
+Function name	:	print_table
+Functionality	:	To print one inverse lookup table
+Arguments		:	Table name, Sweep samples, Top speed common to both wheels
+Return Value	:	None
+Example Call	:	print_table("left_motor_lut", left, 300.0)
+***********************************/
+void print_table(const char *name, const std::vector<Sample> &samples, double top_RPM)
+{
+	printf("const unsigned int %s[256] PROGMEM =\n{\n", name);
+	
+	for (int i=0; i<256; i++)
+	{
+		unsigned int duty = (i == 0) ? 0 : (unsigned int)(inverse_duty(samples, i*top_RPM/255.0) + 0.5);
+		
+		if ((i % 16) == 0) printf("\t");
+		printf("%3u%s", duty, (i == 255) ? "\n" : (((i % 16) == 15) ? ",\n" : ", "));
+	}
+	
+	printf("};\n");
+}
+
+/**********************************
+Function name	:	main
+Functionality	:	To read the sweep from stdin and print the lookup table header
+Arguments		:	None
+Return Value	:	0 on success
+Example Call	:	./motor_lut < sweep.csv > ../Motors/motor_lut.h
+***********************************/
+int main()
+{
+	std::vector<Sample> left, right;
+	double duty=0, left_RPM=0, right_RPM=0;
+	char line[128];
+	
+	// duty,left_RPM,right_RPM lines, the header line is skipped
+	while (fgets(line, sizeof(line), stdin))
+	{
+		if (sscanf(line, "%lf,%lf,%lf", &duty, &left_RPM, &right_RPM) != 3) continue;
+		left.push_back({duty, left_RPM});
+		right.push_back({duty, right_RPM});
+	}
+	
+	if (left.size() < 2)
+	{
+		fprintf(stderr, "motor_lut: expected duty,left_RPM,right_RPM lines on stdin\n");
+		return 1;
+	}
+	
+	make_monotonic(left);
+	make_monotonic(right);
+	
+	// Slower wheel sets the full scale so both reach it
+	double top_RPM = left.back().RPM < right.back().RPM ? left.back().RPM : right.back().RPM;
+	if (top_RPM <= 0)
+	{
+		fprintf(stderr, "motor_lut: wheels did not move during the sweep\n");
+		return 1;
+	}
+	
+	printf("/*\n");
+	printf("* Project Name: Balance_Bot_2403\n");
+	printf("* File Name: motor_lut.h\n");
+	printf("*\n");
+	printf("* Inverse motor characteristic lookup tables\n");
+	printf("* Index: |command| (0-255, linear in wheel speed), Value: Timer 5 duty (0-MOTOR_PWM_MAX)\n");
+	printf("*\n");
+	printf("* Generated by Tools/motor_lut.cpp, full scale %.1f RPM\n", top_RPM);
+	printf("*/\n\n");
+	printf("#ifndef MOTOR_LUT_H_\n#define MOTOR_LUT_H_\n\n");
+	printf("#include <avr/pgmspace.h>\n\n");
+	
+	printf("// Left motor\n");
+	print_table("left_motor_lut", left, top_RPM);
+	printf("\n// Right motor\n");
+	print_table("right_motor_lut", right, top_RPM);
+	
+	printf("\n#endif");
+	return 0;
+}
\ No newline at end of file
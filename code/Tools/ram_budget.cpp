@@ -0,0 +1,358 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: ram_budget.cpp
+*
+* Created: 19-Oct-26 4:47:48 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host build check of the SRAM use. Adds the static data of the firmware ELF (.data, .bss
+* and .noinit, the Data of avr-size) to the worst case stack found from the call graph,
+* and fails when the sum is over RAM_BUDGET of Stack/stack.h
+*
+* Build: g++ -std=gnu++17 -O2 -o ram_budget ram_budget.cpp
+* Usage: ./ram_budget [-b budget bytes] [-u unknown frame bytes] [-n] [-v] firmware.elf callgraph.ci|directory...
+*
+* The call graph and the frame sizes come from the .ci files of avr-gcc 10 or newer with
+* -fcallgraph-info=su (next to the object files, directories are searched). In the Arduino
+* IDE add to platform.local.txt:
+*   compiler.cpp.extra_flags=-fcallgraph-info=su
+*   recipe.hooks.postbuild.1.pattern=<path>/ram_budget "{build.path}/{build.project_name}.elf" "{build.path}"
+*
+* Worst case stack: the deepest path from main(), plus the deepest ISR (__vector_*) on
+* top of it with its return address. The ISRs do not re-enable interrupts, -n adds every
+* ISR instead for nesting ISRs. Functions without a frame size (libgcc float routines,
+* precompiled core objects) and indirect calls count -u bytes each and are listed with -v.
+* Compare the result with the high-water mark of the stack telemetry (TELEMETRY_STACK).
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <unistd.h>
+#include "../Stack/stack.h"
+
+#define RETURN_ADDRESS		3			// Bytes pushed by a call on the ATmega2560 (17-bit PC)
+#define UNKNOWN_FRAME		32			// Default stack of a function without a frame size (bytes)
+#define ROOT_FUNCTION		"main"
+#define ISR_PREFIX			"__vector_"
+
+// One function of the call graph
+struct Function
+{
+	std::string name;			// Readable name from the label
+	int frame = -1;				// Frame size (bytes), -1 when not known
+	bool bounded = true;		// False for a dynamic frame without a bound (alloca, VLA)
+	std::set<std::string> callees;
+	
+	// Worst case from this function, filled by stack_depth()
+	int depth = -1;
+	std::string deepest;		// Callee on the deepest path
+	bool visiting = false;
+};
+
+std::map<std::string, Function> functions;
+std::set<std::string> unknown;
+int unknown_frame = UNKNOWN_FRAME;
+
+/**********************************
+Function name	:	read_file
+Functionality	:	To read a whole file
+Arguments		:	File name, Contents
+Return Value	:	None, exits if the file cannot be read
+Example Call	:	read_file("firmware.elf", data)
+***********************************/
+void read_file(const std::string &name, std::string &data)
+{
+	FILE *file = fopen(name.c_str(), "rb");
+	char buffer[4096];
+	size_t count = 0;
+	
+	if (!file)
+	{
+		perror(name.c_str());
+		exit(1);
+	}
+	data.clear();
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) data.append(buffer, count);
+	fclose(file);
+}
+
+/**********************************
+Function name	:	read_unsigned
+Functionality	:	To decode a little endian unsigned value of the ELF file
+Arguments		:	File data, Offset, Size (bytes)
+Return Value	:	Value
+Example Call	:	read_unsigned(data, 0x20, 4)
+***********************************/
+unsigned long read_unsigned(const std::string &data, size_t offset, int size)
+{
+	unsigned long value = 0;
+	
+	if (offset + size > data.size()) return 0;
+	for (int i=size-1; i>=0; i--) value = (value << 8) | (unsigned char)data[offset + i];
+	return value;
+}
+
+/**********************************
+Function name	:	static_data
+Functionality	:	To add the sizes of the .data, .bss and .noinit sections of an ELF file
+Arguments		:	File name
+Return Value	:	Static data (bytes), exits if the file is not a little endian ELF
+Example Call	:	static_data("firmware.elf")
+***********************************/
+unsigned long static_data(const char *name)
+{
+	std::string data;
+	unsigned long total = 0, table = 0, strings = 0;
+	int wide = 0, entry = 0, count = 0, names = 0;
+	
+	read_file(name, data);
+	if ((data.size() < 64) || memcmp(data.data(), "\177ELF", 4) || (data[5] != 1))
+	{
+		fprintf(stderr, "%s: not a little endian ELF file\n", name);
+		exit(1);
+	}
+	
+	// ELF32 (AVR) or ELF64 header fields
+	wide = (data[4] == 2);
+	table = read_unsigned(data, wide ? 0x28 : 0x20, wide ? 8 : 4);
+	entry = read_unsigned(data, wide ? 0x3A : 0x2E, 2);
+	count = read_unsigned(data, wide ? 0x3C : 0x30, 2);
+	names = read_unsigned(data, wide ? 0x3E : 0x32, 2);
+	strings = read_unsigned(data, table + names*entry + (wide ? 0x18 : 0x10), wide ? 8 : 4);
+	
+	for (int i=0; i<count; i++)
+	{
+		size_t header = table + i*entry;
+		size_t offset = strings + read_unsigned(data, header, 4);
+		unsigned long size = read_unsigned(data, header + (wide ? 0x20 : 0x14), wide ? 8 : 4);
+		
+		if (offset >= data.size()) continue;
+		const char *section = data.c_str() + offset;
+		if (!strcmp(section, ".data") || !strcmp(section, ".bss") || !strcmp(section, ".noinit")) total += size;
+	}
+	
+	return total;
+}
+
+/**********************************
+Function name	:	quoted
+Functionality	:	To get the quoted value of a field of a call graph line
+Arguments		:	Line, Field name with the colon, Value
+Return Value	:	True if the field is present
+Example Call	:	quoted(line, "title:", title)
+***********************************/
+bool quoted(const std::string &line, const char *field, std::string &value)
+{
+	size_t start = line.find(field), end = 0;
+	
+	if (start == std::string::npos) return false;
+	start = line.find('"', start);
+	if (start == std::string::npos) return false;
+	end = start + 1;
+	while ((end < line.size()) && (line[end] != '"'))
+	{
+		if (line[end] == '\\') end++;
+		end++;
+	}
+	value = line.substr(start + 1, end - start - 1);
+	return true;
+}
+
+/**********************************
+Function name	:	read_callgraph
+Functionality	:	To add the functions and calls of a .ci file to the call graph
+Arguments		:	File name
+Return Value	:	None
+Example Call	:	read_callgraph("Balance_Bot_2403.ino.ci")
+***********************************/
+void read_callgraph(const std::string &name)
+{
+	std::string data, line, title, label, target;
+	size_t position = 0, end = 0;
+	
+	read_file(name, data);
+	while (position < data.size())
+	{
+		end = data.find('\n', position);
+		if (end == std::string::npos) end = data.size();
+		line = data.substr(position, end - position);
+		position = end + 1;
+		
+		// node: { title: "_Z9read_gyrov" label: "void read_gyro()\ngyro.cpp:40:6\n12 bytes (static)" }
+		if (!line.compare(0, 5, "node:") && quoted(line, "title:", title) && quoted(line, "label:", label))
+		{
+			Function *function = &functions[title];
+			size_t bytes = label.find(" bytes (");
+			std::string readable = label.substr(0, label.find("\\n"));
+			
+			// Some library declarations have a broken label (just ")"), keep the symbol for those
+			if (readable.find('(') == std::string::npos) readable = title;
+			if (function->name.empty() || (function->name == title)) function->name = readable;
+			if (bytes == std::string::npos) continue;
+			
+			size_t digits = label.rfind("\\n", bytes);
+			digits = (digits == std::string::npos) ? 0 : digits + 2;
+			function->frame = atoi(label.c_str() + digits);
+			function->bounded = (label.compare(bytes, 16, " bytes (dynamic)") != 0);
+		}
+		
+		// edge: { sourcename: "main" targetname: "_Z4loopv" label: "..." }
+		else if (!line.compare(0, 5, "edge:") && quoted(line, "sourcename:", title) && quoted(line, "targetname:", target))
+		{
+			functions[title].callees.insert(target);
+			if (functions[target].name.empty()) functions[target].name = target;
+		}
+	}
+}
+
+/**********************************
+Function name	:	stack_depth
+Functionality	:	To find the deepest stack from a function down its calls
+Arguments		:	Function title
+Return Value	:	Stack (bytes), -1 for recursion
+Example Call	:	stack_depth("main")
+***********************************/
+int stack_depth(const std::string &title)
+{
+	Function *function = &functions[title];
+	int deepest = 0, depth = 0;
+	
+	if (function->depth >= 0) return function->depth;
+	if (function->visiting)
+	{
+		fprintf(stderr, "Recursion through %s, the stack is not bounded\n", function->name.c_str());
+		return -1;
+	}
+	function->visiting = true;
+	
+	for (const std::string &callee : function->callees)
+	{
+		depth = stack_depth(callee);
+		if (depth < 0) return -1;
+		if (RETURN_ADDRESS + depth > deepest)
+		{
+			deepest = RETURN_ADDRESS + depth;
+			function->deepest = callee;
+		}
+	}
+	
+	if (function->frame < 0) unknown.insert(function->name);
+	function->depth = ((function->frame < 0) ? unknown_frame : function->frame) + deepest;
+	function->visiting = false;
+	return function->depth;
+}
+
+/**********************************
+Function name	:	print_path
+Functionality	:	To print the deepest call path from a function
+Arguments		:	Function title
+Return Value	:	None
+Example Call	:	print_path("main")
+***********************************/
+void print_path(std::string title)
+{
+	while (!title.empty())
+	{
+		const Function *function = &functions[title];
+		if (function->frame < 0) printf("    %5s  %s\n", "?", function->name.c_str());
+		else printf("    %5d  %s\n", function->frame, function->name.c_str());
+		title = function->deepest;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int budget = RAM_BUDGET, option = 0, main_depth = 0, isr_depth = 0, worst_isr = 0, depth = 0;
+	bool nesting = false, verbose = false, bounded = true;
+	unsigned long data = 0, total = 0;
+	std::string isr;
+	
+	while ((option = getopt(argc, argv, "b:u:nv")) != -1)
+	{
+		switch (option)
+		{
+			case 'b': budget = atoi(optarg); break;
+			case 'u': unknown_frame = atoi(optarg); break;
+			case 'n': nesting = true; break;
+			case 'v': verbose = true; break;
+			default:
+				fprintf(stderr, "Usage: %s [-b budget bytes] [-u unknown frame bytes] [-n] [-v] firmware.elf callgraph.ci|directory...\n", argv[0]);
+				return 1;
+		}
+	}
+	if (argc - optind < 2)
+	{
+		fprintf(stderr, "Usage: %s [-b budget bytes] [-u unknown frame bytes] [-n] [-v] firmware.elf callgraph.ci|directory...\n", argv[0]);
+		return 1;
+	}
+	
+	data = static_data(argv[optind]);
+	for (int i=optind+1; i<argc; i++)
+	{
+		if (!std::filesystem::is_directory(argv[i])) read_callgraph(argv[i]);
+		else for (const auto &file : std::filesystem::recursive_directory_iterator(argv[i]))
+		{
+			if (file.path().extension() == ".ci") read_callgraph(file.path().string());
+		}
+	}
+	if (!functions.count(ROOT_FUNCTION))
+	{
+		fprintf(stderr, "No %s() in the call graph, build with -fcallgraph-info=su\n", ROOT_FUNCTION);
+		return 1;
+	}
+	
+	// Deepest path from main(), then the ISRs on top of it
+	main_depth = stack_depth(ROOT_FUNCTION);
+	if (main_depth < 0) return 1;
+	for (auto &entry : functions)
+	{
+		if (entry.first.compare(0, strlen(ISR_PREFIX), ISR_PREFIX)) continue;
+		depth = stack_depth(entry.first);
+		if (depth < 0) return 1;
+		depth += RETURN_ADDRESS;
+		if (nesting) isr_depth += depth;
+		if (depth > worst_isr)
+		{
+			worst_isr = depth;
+			isr = entry.first;
+		}
+	}
+	if (!nesting) isr_depth = worst_isr;
+	for (auto &entry : functions) bounded = bounded && entry.second.bounded;
+	total = data + main_depth + isr_depth;
+	
+	printf("static data      %6lu bytes\n", data);
+	printf("stack from main  %6d bytes\n", main_depth);
+	if (verbose) print_path(ROOT_FUNCTION);
+	if (isr.empty()) printf("stack of ISRs    %6d bytes, no %s* function found\n", isr_depth, ISR_PREFIX);
+	else printf("stack of ISRs    %6d bytes%s%s\n", isr_depth, nesting ? ", all nested" : ", deepest ", nesting ? "" : isr.c_str());
+	if (verbose && !isr.empty()) print_path(isr);
+	printf("total            %6lu bytes of %d budget, %d SRAM\n", total, budget, SRAM_SIZE);
+	
+	if (!unknown.empty())
+	{
+		printf("%d functions without a frame size counted as %d bytes\n", (int)unknown.size(), unknown_frame);
+		if (verbose) for (const std::string &name : unknown) printf("    %s\n", name.c_str());
+	}
+	if (!bounded)
+	{
+		printf("FAIL: a dynamic stack frame without a bound\n");
+		return 1;
+	}
+	if (total > (unsigned long)budget)
+	{
+		printf("FAIL: over the RAM budget by %lu bytes\n", total - budget);
+		return 1;
+	}
+	printf("OK: %lu bytes left in the budget\n", budget - total);
+	
+	return 0;
+}
\ No newline at end of file
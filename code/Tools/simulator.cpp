@@ -0,0 +1,612 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: simulator.cpp
+*
+* Created: 19-Oct-26 4:32:38 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host closed loop simulator, built with the firmware sources and the register stand-ins
+* in Tools/host. Balance_Bot_2403.cpp is included here (and left out of the build line)
+* so that the PID structures and flags of the main file can be reached
+*
+* Functions: sim_defaults, sim_random, sim_run, sim_batch, read_gains, write_gains,
+* plant_step, bridge_input, encoder_edges, sensor_interrupt, sensor_raw, loop_measurement,
+* loop_inject, loop_fourier
+*
+* Global Variables: Serial
+*
+* The plant is a batch of one robot of batch_plant.h, stepped on the scalar path: the
+* firmware state is global, so a process runs one robot. Tools/gain_map.cpp steps a whole
+* batch with pid_angle_update() of the firmware and no other firmware state.
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "../Balance_Bot_2403.cpp"
+#include "batch_plant.h"
+#include "simulator.h"
+
+// Sensor constants
+#define SENSOR_HEIGHT		0.06		// GY80 above the axle (m)
+#define GYRO_SCALE			0.07		// L3G4200D at 2000 DPS (DPS/LSB)
+#define ACCEL_SCALE			256.0		// ADXL345 full resolution (LSB/g)
+#define MAG_NOISE			1.5			// Magnetometer heading noise (deg RMS)
+
+// Random scenarios
+#define DRIVE_TIME			10.0		// Joystick sequence length (s)
+#define COMMAND_MIN			0.5			// Shortest joystick command (s)
+#define COMMAND_MAX			2.5			// Longest joystick command (s)
+#define COMMAND_IDLE		0.3			// Chance of a released stick
+#define INITIAL_TILT_MAX	5.0			// Uniform (deg)
+#define CG_OFFSET_SD		1.0			// Normal (deg)
+#define GYRO_BIAS_SD		0.5			// Normal (DPS)
+#define GYRO_NOISE_MIN		0.1			// Uniform (DPS RMS)
+#define GYRO_NOISE_MAX		0.5
+#define ACCEL_NOISE_MIN		0.005		// Uniform (g RMS)
+#define ACCEL_NOISE_MAX		0.04
+#define DEADBAND_MIN		0.08		// Uniform, independent for each motor
+#define DEADBAND_MAX		0.20
+#define BATTERY_MIN			3.5			// Uniform (V)
+#define BATTERY_MAX			4.2
+
+#define SIM_STEP			0.001		// Physics step, one Timer 4 overflow (s)
+#define RAD_TO_DEG			(180.0/M_PI)
+
+// Firmware variables and ISRs without a module header
+extern float yaw_rate;
+extern volatile unsigned int battery_filter;
+extern "C" void TIMER4_OVF_vect();
+extern "C" void TIMER4_COMPB_vect();
+extern "C" void TIMER5_CAPT_vect();
+
+// Serial of the bare-metal build, nothing is read and the telemetry is dropped
+BareSerial Serial;
+void BareSerial::begin(unsigned long baud) {}
+int BareSerial::available() {return 0;}
+int BareSerial::read() {return -1;}
+void BareSerial::write(unsigned char data) {}
+void BareSerial::print(const char *text) {}
+void BareSerial::print(long value) {}
+void BareSerial::print(unsigned long value) {}
+void BareSerial::print(double value, int digits) {}
+
+/**********************************
+Function name	:	read_gains
+Functionality	:	To copy the six gains of a PID controller
+Arguments		:	PID controller, Gains
+Return Value	:	None
+Example Call	:	read_gains(&angle, &params->gains[SIM_ANGLE_GAINS])
+***********************************/
+void read_gains(const PID *pid, float *gains)
+{
+	gains[0] = pid->con_KP;
+	gains[1] = pid->con_KI;
+	gains[2] = pid->con_KD;
+	gains[3] = pid->agr_KP;
+	gains[4] = pid->agr_KI;
+	gains[5] = pid->agr_KD;
+}
+
+/**********************************
+Function name	:	write_gains
+Functionality	:	To set the six gains of a PID controller
+Arguments		:	PID controller, Gains
+Return Value	:	None
+Example Call	:	write_gains(&angle, &params->gains[SIM_ANGLE_GAINS])
+***********************************/
+void write_gains(PID *pid, const float *gains)
+{
+	pid->con_KP = gains[0];
+	pid->con_KI = gains[1];
+	pid->con_KD = gains[2];
+	pid->agr_KP = gains[3];
+	pid->agr_KI = gains[4];
+	pid->agr_KD = gains[5];
+}
+
+/**********************************
+Function name	:	sim_defaults
+Functionality	:	To set up a nominal scenario with the gains of pid_gains.h,
+					no noise or bias and no joystick commands
+Arguments		:	Scenario parameters
+Return Value	:	None
+Example Call	:	sim_defaults(&params)
+***********************************/
+void sim_defaults(SimParams *params)
+{
+	memset(params, 0, sizeof(SimParams));
+	params->duration = SIM_SETTLE_TIME + SIM_HOLD_TIME;
+	params->deadband[0] = params->deadband[1] = 0.13;	// Minimum duty of motor_lut.h
+	params->battery = BATTERY_NOMINAL;
+	params->seed = 2403;
+	
+	read_gains(&angle, &params->gains[SIM_ANGLE_GAINS]);
+	read_gains(&velocity, &params->gains[SIM_VELOCITY_GAINS]);
+	read_gains(&encoder, &params->gains[SIM_ENCODER_GAINS]);
+}
+
+/**********************************
+Function name	:	sim_random
+Functionality	:	To draw a scenario with random sensor errors, CG offset, motor friction,
+					battery voltage and joystick sequence. It balances for SIM_SETTLE_TIME
+					from a random tilt, drives and ends with SIM_HOLD_TIME of position hold
+Arguments		:	Scenario parameters, Seed
+Return Value	:	None
+Example Call	:	sim_random(&params, 2403)
+***********************************/
+void sim_random(SimParams *params, unsigned long seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> uniform(0, 1);
+	std::normal_distribution<float> normal(0, 1);
+	float time = SIM_SETTLE_TIME;
+	
+	sim_defaults(params);
+	params->seed = seed;
+	params->initial_tilt = INITIAL_TILT_MAX*(2*uniform(random) - 1);
+	params->cg_offset = CG_OFFSET_SD*normal(random);
+	params->gyro_bias = GYRO_BIAS_SD*normal(random);
+	params->gyro_noise = GYRO_NOISE_MIN + (GYRO_NOISE_MAX - GYRO_NOISE_MIN)*uniform(random);
+	params->accel_noise = ACCEL_NOISE_MIN + (ACCEL_NOISE_MAX - ACCEL_NOISE_MIN)*uniform(random);
+	params->deadband[0] = DEADBAND_MIN + (DEADBAND_MAX - DEADBAND_MIN)*uniform(random);
+	params->deadband[1] = DEADBAND_MIN + (DEADBAND_MAX - DEADBAND_MIN)*uniform(random);
+	params->battery = BATTERY_MIN + (BATTERY_MAX - BATTERY_MIN)*uniform(random);
+	
+	// Joystick sequence, then the stick is released for the hold
+	while ((time < SIM_SETTLE_TIME + DRIVE_TIME) && (params->command_count < SIM_MAX_COMMANDS - 1))
+	{
+		SimCommand *command = &params->commands[params->command_count++];
+		command->time = time;
+		if (uniform(random) >= COMMAND_IDLE)
+		{
+			command->y_command = 2*uniform(random) - 1;
+			if (uniform(random) < 0.5) command->x_command = 2*uniform(random) - 1;
+		}
+		time += COMMAND_MIN + (COMMAND_MAX - COMMAND_MIN)*uniform(random);
+	}
+	params->commands[params->command_count++] = {time, 0, 0};
+	params->duration = time + SIM_HOLD_TIME;
+}
+
+/**********************************
+Function name	:	bridge_input
+Functionality	:	To set the plant input of a motor from the bridge state set by the firmware
+Arguments		:	Plant, Motor (LEFT/RIGHT)
+Return Value	:	None
+Example Call	:	bridge_input(&plant, LEFT)
+***********************************/
+void bridge_input(BatchPlant *plant, int motor)
+{
+	bool pin1, pin2, enabled;
+	double duty=0;
+	int side = (motor == LEFT) ? 0 : 1;
+	
+	// Direction pins (set_motor_pin) and enable output (set_motor_output)
+	if (motor == LEFT)
+	{
+		pin1 = PORTH & 0x20;
+		pin2 = PORTH & 0x10;
+		enabled = TCCR5A & 0x80;
+		duty = OCR5A;
+	}
+	else
+	{
+		pin1 = PORTB & 0x40;
+		pin2 = PORTB & 0x20;
+		enabled = TCCR5A & 0x20;
+		duty = OCR5B;
+	}
+	duty = enabled ? duty/MOTOR_PWM_MAX : 0;
+	
+	// Coast leaves the motor open, brake shorts it, forward/back apply the average voltage
+	if (pin1 == pin2)
+	{
+		plant->closed[side][0] = pin1 && enabled;
+		duty = 0;
+	}
+	else plant->closed[side][0] = 1;
+	plant->duty[side][0] = pin1 ? -duty : duty;
+}
+
+/**********************************
+Function name	:	encoder_edges
+Functionality	:	To run the encoder ISR of a wheel for every count crossed in a step, with
+					the channel pins and Timer 4 count of the edge time
+Arguments		:	Motor (LEFT/RIGHT), Count at the start and end of the step
+Return Value	:	None
+Example Call	:	encoder_edges(LEFT, 10.2, 12.7)
+***********************************/
+void encoder_edges(int motor, double from, double to)
+{
+	double edge=0;
+	int direction = (to > from) ? 1 : -1;
+	
+	// Channel pin levels decoded as forward/back by the ISRs
+	if (motor == LEFT) PIND = (direction > 0) ? 0x08 : 0x0C;
+	else PINE = (direction > 0) ? 0x30 : 0x10;
+	
+	edge = (direction > 0) ? floor(from) + 1 : ceil(from) - 1;
+	while ((direction > 0) ? (edge <= to) : (edge >= to))
+	{
+		TCNT4 = TIMER4_BOTTOM + (unsigned int)((edge - from)/(to - from)*TIMER4_TICKS_PER_MS);
+		if (motor == LEFT) left_encoder_interrupt();
+		else right_encoder_interrupt();
+		edge += direction;
+	}
+	TCNT4 = TIMER4_BOTTOM;
+}
+
+/**********************************
+Function name	:	plant_step
+Functionality	:	To advance the plant by one step under the motor commands of the firmware
+Arguments		:	Plant, Left and right wheel rotation relative to the body (counts)
+Return Value	:	None
+Example Call	:	plant_step(&plant, encoder)
+***********************************/
+void plant_step(BatchPlant *plant, double *encoder)
+{
+	const double r = WHEEL_RADIUS, half_track = WHEEL_TRACK/2;
+	double left_count=0, right_count=0;
+	
+	bridge_input(plant, LEFT);
+	bridge_input(plant, RIGHT);
+	batch_step(plant, SIM_STEP);
+	
+	// Encoder edges
+	left_count = ((plant->x[0] - plant->yaw[0]*half_track)/r - plant->pitch[0])*ENCODER_CPR/(2*M_PI);
+	right_count = ((plant->x[0] + plant->yaw[0]*half_track)/r - plant->pitch[0])*ENCODER_CPR/(2*M_PI);
+	if (floor(left_count) != floor(encoder[0])) encoder_edges(LEFT, encoder[0], left_count);
+	if (floor(right_count) != floor(encoder[1])) encoder_edges(RIGHT, encoder[1], right_count);
+	encoder[0] = left_count;
+	encoder[1] = right_count;
+}
+
+/**********************************
+Function name	:	sensor_raw
+Functionality	:	To quantise a reading to the signed 16-bit output of a sensor
+Arguments		:	Reading, Scale (LSB per unit)
+Return Value	:	Raw reading
+Example Call	:	sensor_raw(12.5, 1/GYRO_SCALE)
+***********************************/
+UINT16 sensor_raw(double value, double scale)
+{
+	double raw = constrain(round(value*scale), -32768, 32767);
+	return (UINT16)(int)raw;
+}
+
+/**********************************
+Function name	:	sensor_interrupt
+Functionality	:	Stand-in for ISR(TIMER3_OVF_vect), runs read_tilt_angle() and read_yaw_angle()
+					on simulated GY80 readings. The sensor X-axis points backward, so leaning
+					forward is a negative tilt
+Arguments		:	Plant, Scenario parameters, Noise generator
+Return Value	:	None
+Example Call	:	sensor_interrupt(&plant, params, noise)
+***********************************/
+void sensor_interrupt(const BatchPlant *plant, const SimParams *params, std::mt19937 &noise)
+{
+	std::normal_distribution<double> normal(0, 1);
+	double pitch = plant->pitch[0], pitch_dot = plant->pitch_dot[0], pitch_ddot = plant->pitch_ddot[0];
+	double s = sin(pitch), co = cos(pitch);
+	double ax=0, az=0, x_accel=0, z_accel=0, rate=0, mag_heading=0;
+	
+	// Gyroscope, the start-up calibration leaves the bias and read_gyro() refines it while still
+	rate = -pitch_dot*RAD_TO_DEG + params->gyro_bias + params->gyro_noise*normal(noise);
+	rate = convert_gyro(sensor_raw(rate, 1/GYRO_SCALE), 0);
+	yaw_rate = convert_gyro(sensor_raw(plant->yaw_dot[0]*RAD_TO_DEG + params->gyro_noise*normal(noise), 1/GYRO_SCALE), 0);
+	update_gyro_bias(rate, yaw_rate);
+	rate -= gyro_bias.offset[0];
+	yaw_rate -= gyro_bias.offset[1];
+	
+	// Accelerometer, specific force at the sensor in the body frame
+	ax = plant->x_ddot[0] + SENSOR_HEIGHT*(co*pitch_ddot - s*pitch_dot*pitch_dot);
+	az = -SENSOR_HEIGHT*(s*pitch_ddot + co*pitch_dot*pitch_dot) + GRAVITY;
+	x_accel = (-ax*co + az*s)/GRAVITY + params->accel_noise*normal(noise);
+	z_accel = (ax*s + az*co)/GRAVITY + params->accel_noise*normal(noise);
+	
+	// read_tilt_angle()
+	gyro_angle = rate*0.01 + tilt_angle;
+	accel_angle = accel_pitch(convert_accelerometer(sensor_raw(x_accel, ACCEL_SCALE)), convert_accelerometer(sensor_raw(z_accel, ACCEL_SCALE)));
+	tilt_angle = complimentary_filter(gyro_angle, accel_angle, COMP_FILTER_ALPHA);
+	
+	// read_yaw_angle(), magnetometer heading every other tick
+	yaw_angle = wrap_angle(yaw_angle + read_yaw_rate()*0.01);
+	MAG_TICK = !MAG_TICK;
+	if (MAG_TICK)
+	{
+		mag_heading = wrap_angle(fmod(plant->yaw[0]*RAD_TO_DEG, 360) + MAG_NOISE*normal(noise));
+		if (!YAW_INIT) yaw_angle = mag_heading;
+		else yaw_angle = wrap_angle(yaw_angle + (1 - YAW_FILTER_ALPHA)*wrap_angle(mag_heading - yaw_angle));
+		YAW_INIT = true;
+	}
+	
+	// Publish the attitude for the control loop
+	shared_state.tilt_angle = tilt_angle;
+	shared_state.gyro_angle = gyro_angle;
+	shared_state.accel_angle = accel_angle;
+	shared_state.yaw_angle = yaw_angle;
+	shared_state.yaw_rate = read_yaw_rate();
+	state_publish();
+}
+
+/**********************************
+Function name	:	loop_measurement
+Functionality	:	To get the measurement of a loop from the sensor state
+Arguments		:	Loop (SIM_LOOP_*)
+Return Value	:	Measurement
+Example Call	:	loop_measurement(SIM_LOOP_ANGLE)
+***********************************/
+double loop_measurement(int loop)
+{
+	switch (loop)
+	{
+		case SIM_LOOP_ANGLE: return shared_state.tilt_angle;
+		case SIM_LOOP_VELOCITY: return (shared_state.left_RPM + shared_state.right_RPM)/2.0;
+		case SIM_LOOP_ENCODER: return shared_state.encoder_count;
+		default: return shared_state.yaw_angle;
+	}
+}
+
+/**********************************
+Function name	:	loop_inject
+Functionality	:	To add a signal to the measurement of a loop in the sensor state,
+					the other loops read their measurements unchanged
+Arguments		:	Loop (SIM_LOOP_*), Signal, Rate of the signal (per s)
+Return Value	:	None
+Example Call	:	loop_inject(SIM_LOOP_ROTATION, 1.5, 10.0)
+***********************************/
+void loop_inject(int loop, double value, double rate)
+{
+	switch (loop)
+	{
+		case SIM_LOOP_ANGLE:
+			shared_state.tilt_angle += value;
+			break;
+		
+		case SIM_LOOP_VELOCITY:
+			shared_state.left_RPM += value;
+			shared_state.right_RPM += value;
+			break;
+		
+		case SIM_LOOP_ENCODER:
+			shared_state.encoder_count += value;
+			break;
+		
+		// The heading controller takes its derivative from the gyroscope
+		default:
+			shared_state.yaw_angle = wrap_angle(shared_state.yaw_angle + value);
+			shared_state.yaw_rate += rate;
+			break;
+	}
+}
+
+/**********************************
+Function name	:	loop_fourier
+Functionality	:	To compute the Fourier coefficient of a sampled signal at a frequency,
+					after removing its straight line fit (position drift of the outer loops).
+					A Hann window keeps the friction limit cycle out of the other frequencies
+Arguments		:	Sample times (s), Samples, Frequency (Hz), Coefficient (real, imaginary)
+Return Value	:	None
+Example Call	:	loop_fourier(times, values, 2.0, result->loop_response)
+***********************************/
+void loop_fourier(const std::vector<double> &times, const std::vector<double> &values, double frequency, float *coefficient)
+{
+	double time_mean=0, value_mean=0, spread=0, slope=0, real=0, imaginary=0, residual=0, window=0, window_sum=0;
+	int count = times.size();
+	
+	coefficient[0] = coefficient[1] = 0;
+	if (count < 2) return;
+	
+	// Least squares line
+	for (int i=0; i<count; i++)
+	{
+		time_mean += times[i]/count;
+		value_mean += values[i]/count;
+	}
+	for (int i=0; i<count; i++)
+	{
+		spread += (times[i] - time_mean)*(times[i] - time_mean);
+		slope += (times[i] - time_mean)*(values[i] - value_mean);
+	}
+	slope /= spread;
+	
+	for (int i=0; i<count; i++)
+	{
+		window = 0.5 - 0.5*cos(2*M_PI*i/(count - 1));
+		residual = window*(values[i] - value_mean - slope*(times[i] - time_mean));
+		real += residual*cos(2*M_PI*frequency*times[i]);
+		imaginary -= residual*sin(2*M_PI*frequency*times[i]);
+		window_sum += window;
+	}
+	coefficient[0] = 2*real/window_sum;
+	coefficient[1] = 2*imaginary/window_sum;
+}
+
+/**********************************
+Function name	:	sim_run
+Functionality	:	To run a scenario in this process. The firmware keeps its state in globals,
+					so this can be done only once per process, sim_batch() forks for every run
+Arguments		:	Scenario parameters, Result
+Return Value	:	None
+Example Call	:	sim_run(&params, &result)
+***********************************/
+void sim_run(const SimParams *params, SimResult *result)
+{
+	std::mt19937 noise(params->seed);
+	BatchPlant plant;
+	unsigned long steps = params->duration/SIM_STEP, ticks=0;
+	double encoder_count[2], error=0, error_sum=0, effort_sum=0, hold_x=0, hold_yaw=0;
+	double phase=0, sine=0;
+	std::vector<double> loop_times, loop_values, loop_sines;
+	RobotState sensors;
+	bool injected=false;
+	int command=0;
+	
+	memset(result, 0, sizeof(SimResult));
+	batch_init(&plant, 1);
+	plant.balance[0] = -(TILT_ANGLE_OFFSET + params->cg_offset)/RAD_TO_DEG;
+	plant.pitch[0] = plant.balance[0] - params->initial_tilt/RAD_TO_DEG;
+	plant.battery[0] = params->battery;
+	plant.friction[0][0] = params->deadband[0];
+	plant.friction[1][0] = params->deadband[1];
+	encoder_count[0] = encoder_count[1] = -plant.pitch[0]*ENCODER_CPR/(2*M_PI);
+	
+	// setup() without the sensor initialisation
+	TCNT4 = TIMER4_BOTTOM;
+	timer5_init();
+	motors_init();
+	battery_filter = (params->battery/BATTERY_DIVIDER)*(1024.0/ADC_REFERENCE)*16;
+	
+	// The start-up calibration is done, gyro_bias of the scenario is what it left
+	gyro_bias.offset[0] = gyro_bias.offset[1] = 0;
+	gyro_bias.calibrated = true;
+	angle.direction = 1;
+	velocity.direction = -1;
+	encoder.direction = -1;
+	write_gains(&angle, &params->gains[SIM_ANGLE_GAINS]);
+	write_gains(&velocity, &params->gains[SIM_VELOCITY_GAINS]);
+	write_gains(&encoder, &params->gains[SIM_ENCODER_GAINS]);
+	
+	for (unsigned long step=1; step<=steps; step++)
+	{
+		double time = step*SIM_STEP;
+		
+		plant_step(&plant, encoder_count);
+		
+		// Interrupts of this millisecond, Timer 1 and 3 are out of phase as on the robot
+		TIMER4_OVF_vect();
+		if (TIMSK4 & 0x04) TIMER4_COMPB_vect();
+		if (step % 10 == 0) sensor_interrupt(&plant, params, noise);
+		if (step % 20 == 5) TIMER1_OVF_vect();
+		
+		// Joystick
+		while ((command < params->command_count) && (params->commands[command].time <= time))
+		{
+			joystick.x_command = params->commands[command].x_command;
+			joystick.y_command = params->commands[command].y_command;
+			command++;
+		}
+		
+		// Sine on the loop measurement read by this PID tick, the sensor state is put back after
+		injected = params->loop && (time >= SIM_SETTLE_TIME) && ((epoch() - last_task_time_PID) >= 20);
+		if (injected)
+		{
+			phase = 2*M_PI*params->loop_frequency*(time - SIM_SETTLE_TIME);
+			sine = params->loop_amplitude*sin(phase);
+			sensors = shared_state;
+			if (time >= params->loop_measure)
+			{
+				loop_times.push_back(time);
+				loop_values.push_back(loop_measurement(params->loop));
+				loop_sines.push_back(sine);
+			}
+			loop_inject(params->loop, sine, 2*M_PI*params->loop_frequency*params->loop_amplitude*cos(phase));
+		}
+		
+		// Main loop, then the Timer 5 TOP interrupt which reconnects the bridge
+		task_scheduler();
+		if (injected) shared_state = sensors;
+		if (TIMSK5 & 0x20) TIMER5_CAPT_vect();
+		
+		// Tilt from the balance point
+		error = (plant.pitch[0] - plant.balance[0])*RAD_TO_DEG;
+		error_sum += error*error;
+		if ((time <= SIM_SETTLE_TIME) && (abs(error) > SIM_SETTLE_BAND)) result->settling_time = time;
+		if (abs(error) > SIM_FALL_ANGLE)
+		{
+			result->fallen = true;
+			result->fall_time = time;
+			break;
+		}
+		
+		// Hold position and heading from the firmware flags
+		if (step % 20 == 0)
+		{
+			effort_sum += abs(angle.output);
+			ticks++;
+		}
+		if (!STOP_FLAG) hold_x = plant.x[0];
+		if (ROTATION_FLAG || !read_ready_state()) hold_yaw = plant.yaw[0];
+	}
+	
+	result->drift = abs(plant.x[0] - hold_x)*1000;
+	result->heading_drift = abs(wrap_angle((plant.yaw[0] - hold_yaw)*RAD_TO_DEG));
+	result->tilt_RMS = sqrt(error_sum/steps);
+	result->effort = ticks ? effort_sum/ticks : 0;
+	loop_fourier(loop_times, loop_values, params->loop_frequency, result->loop_response);
+	loop_fourier(loop_times, loop_sines, params->loop_frequency, result->loop_injection);
+	batch_free(&plant);
+}
+
+/**********************************
+Function name	:	sim_batch
+Functionality	:	To run scenarios in parallel, each in a child process forked from
+					the untouched firmware state
+Arguments		:	Scenario parameters, Results, Number of scenarios, Parallel processes
+Return Value	:	None
+Example Call	:	sim_batch(params, results, 1000, 8)
+***********************************/
+void sim_batch(const SimParams *params, SimResult *results, int count, int jobs)
+{
+	int running=0, status=0;
+	pid_t child;
+	
+	// Results are written by the children into shared memory
+	SimResult *shared = (SimResult*)mmap(NULL, count*sizeof(SimResult), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (shared == MAP_FAILED)
+	{
+		perror("mmap");
+		exit(1);
+	}
+	
+	fflush(NULL);
+	for (int i=0; i<count; i++)
+	{
+		if (running >= jobs)
+		{
+			wait(&status);
+			running--;
+			if (!WIFEXITED(status) || WEXITSTATUS(status))
+			{
+				fprintf(stderr, "simulator: scenario process failed\n");
+				exit(1);
+			}
+		}
+		
+		child = fork();
+		if (child < 0)
+		{
+			perror("fork");
+			exit(1);
+		}
+		if (child == 0)
+		{
+			sim_run(&params[i], &shared[i]);
+			_exit(0);
+		}
+		running++;
+	}
+	
+	while (running-- > 0)
+	{
+		wait(&status);
+		if (!WIFEXITED(status) || WEXITSTATUS(status))
+		{
+			fprintf(stderr, "simulator: scenario process failed\n");
+			exit(1);
+		}
+	}
+	
+	memcpy(results, shared, count*sizeof(SimResult));
+	munmap(shared, count*sizeof(SimResult));
+}
\ No newline at end of file
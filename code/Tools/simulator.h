@@ -0,0 +1,132 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: simulator.h
+*
+* Created: 19-Oct-26 4:32:38 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host closed loop simulator. The firmware control loop (task_scheduler(), the RPM ISR,
+* the encoder ISRs and the motor driver) runs unchanged on a two wheeled inverted
+* pendulum model, the GY80 reads of the Timer 3 ISR are replaced by simulated sensors
+*/
+
+#ifndef SIMULATOR_H_
+#define SIMULATOR_H_
+
+#define SIM_MAX_COMMANDS	32
+#define SIM_SETTLE_TIME		5.0			// Quiet start, the initial tilt is recovered here (s)
+#define SIM_HOLD_TIME		5.0			// Quiet end, the position hold is measured here (s)
+#define SIM_SETTLE_BAND		2.0			// Tilt band around the balance point for settling (deg)
+#define SIM_FALL_ANGLE		45.0		// Tilt from the balance point at which the robot has fallen (deg)
+
+// Gains, six per controller in the order of pid_gains.h
+#define SIM_ANGLE_GAINS		0
+#define SIM_VELOCITY_GAINS	6
+#define SIM_ENCODER_GAINS	12
+#define SIM_GAIN_COUNT		18
+
+// Loops of the cascade, broken at the measurement read by their controller
+#define SIM_LOOP_NONE		0
+#define SIM_LOOP_ANGLE		1			// Tilt angle (deg)
+#define SIM_LOOP_VELOCITY	2			// Mean of the wheel RPMs
+#define SIM_LOOP_ENCODER	3			// Sum of the encoder counts
+#define SIM_LOOP_ROTATION	4			// Heading (deg), with the yaw rate as its derivative
+
+// Joystick command, held until the next one
+typedef struct SimCommand
+{
+	float time;				// Start time (s)
+	float x_command;		// Turn command (-1 to 1)
+	float y_command;		// Drive command (-1 to 1)
+};
+
+// Structure to hold the parameters of a scenario
+typedef struct SimParams
+{
+	float duration;			// Simulated time (s)
+	float initial_tilt;		// Tilt from the balance point at the start (deg)
+	float cg_offset;		// Balance point error from TILT_ANGLE_OFFSET (deg)
+	float gyro_bias;		// Pitch rate bias left after the offset calibration (DPS)
+	float gyro_noise;		// Rate noise of both gyroscope axes (DPS RMS)
+	float accel_noise;		// Accelerometer noise (g RMS)
+	float deadband[2];		// Left and right drive friction (fraction of stall torque)
+	float battery;			// Battery voltage (V)
+	unsigned long seed;		// Sensor noise seed
+	float gains[SIM_GAIN_COUNT];	// Controller gains, pid_gains.h by default
+	
+	// Sine added to the measurement of a loop from SIM_SETTLE_TIME, none by default
+	int loop;				// SIM_LOOP_*
+	float loop_amplitude;	// In the unit of the loop measurement
+	float loop_frequency;	// (Hz)
+	float loop_measure;		// Start of the response measurement, after the transient (s)
+	
+	int command_count;		// Joystick commands in use
+	SimCommand commands[SIM_MAX_COMMANDS];
+};
+
+// Structure to hold the outcome of a scenario
+typedef struct SimResult
+{
+	bool fallen;			// Tilt went past SIM_FALL_ANGLE, the run is stopped there
+	float fall_time;		// Time of the fall (s)
+	float settling_time;	// Time after which the tilt stays within SIM_SETTLE_BAND of the
+							// balance point during the quiet start (s), SIM_SETTLE_TIME if it never does
+	float drift;			// Distance from the last hold position at the end (mm)
+	float heading_drift;	// Heading change since the last turn command at the end (deg)
+	float tilt_RMS;			// Tilt from the balance point over the run (deg)
+	float effort;			// Mean magnitude of the angle PID output (PWM)
+	
+	// Fourier coefficients (real, imaginary) at loop_frequency over the PID ticks
+	// from loop_measure to the end, the open loop response is -response/(response + injection)
+	float loop_response[2];		// Loop measurement without the sine, trend removed
+	float loop_injection[2];	// Sine
+};
+
+
+// Function Declarations
+
+/**********************************
+Function name	:	sim_defaults
+Functionality	:	To set up a nominal scenario with the gains of pid_gains.h,
+					no noise or bias and no joystick commands
+Arguments		:	Scenario parameters
+Return Value	:	None
+Example Call	:	sim_defaults(&params)
+***********************************/
+void sim_defaults(SimParams *params);
+
+/**********************************
+Function name	:	sim_random
+Functionality	:	To draw a scenario with random sensor errors, CG offset, motor friction,
+					battery voltage and joystick sequence. It balances for SIM_SETTLE_TIME
+					from a random tilt, drives and ends with SIM_HOLD_TIME of position hold
+Arguments		:	Scenario parameters, Seed
+Return Value	:	None
+Example Call	:	sim_random(&params, 2403)
+***********************************/
+void sim_random(SimParams *params, unsigned long seed);
+
+/**********************************
+Function name	:	sim_run
+Functionality	:	To run a scenario in this process. The firmware keeps its state in globals,
+					so this can be done only once per process, sim_batch() forks for every run
+Arguments		:	Scenario parameters, Result
+Return Value	:	None
+Example Call	:	sim_run(&params, &result)
+***********************************/
+void sim_run(const SimParams *params, SimResult *result);
+
+/**********************************
+Function name	:	sim_batch
+Functionality	:	To run scenarios in parallel, each in a child process forked from
+					the untouched firmware state
+Arguments		:	Scenario parameters, Results, Number of scenarios, Parallel processes
+Return Value	:	None
+Example Call	:	sim_batch(params, results, 1000, 8)
+***********************************/
+void sim_batch(const SimParams *params, SimResult *results, int count, int jobs);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,364 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: sysid_fit.cpp
+*
+* Created: 19-Oct-26 4:10:45 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host tool to fit a transfer function and frequency response to a SYSID_MODE log
+*
+* Build: g++ -O2 -o sysid_fit sysid_fit.cpp
+* Usage: ./sysid_fit [-u excitation|command] [-y rpm|angle] [-n order] [-c log.csv] capture.bin
+*
+* capture.bin is the raw serial stream of the PC XBee (API mode 1) receiving the
+* telemetry frames, e.g. cat /dev/ttyUSB0 > capture.bin
+*/
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#define SAMPLE_PERIOD		0.02		// SYSID_PERIOD
+#define TELEMETRY_SYSID		0x02
+#define XBEE_RX_16BIT		0x81		// RX Packet Frame, 16-bit source address
+#define MAX_ORDER			4
+
+typedef std::complex<double> Complex;
+
+// One control tick of the log
+struct Sample
+{
+	unsigned int tick;
+	double excitation;
+	double command;
+	double angle;
+	double left_RPM;
+	double right_RPM;
+};
+
+/**********************************
+Function name	:	read_int
+Functionality	:	To decode a big endian signed 16-bit value
+Arguments		:	Pointer to the data, Scale factor
+Return Value	:	Decoded value
+Example Call	:	read_int(&data[4], 100)
+***********************************/
+double read_int(const unsigned char *data, double scale)
+{
+	return (short)((data[0] << 8) | data[1])/scale;
+}
+
+/**********************************
+Function name	:	read_capture
+Functionality	:	To extract the system identification samples from the XBee frames of a capture
+Arguments		:	File name, Samples
+Return Value	:	Number of frames with a bad checksum
+Example Call	:	read_capture("capture.bin", samples)
+***********************************/
+int read_capture(const char *name, std::vector<Sample> &samples)
+{
+	FILE *file = fopen(name, "rb");
+	if (!file)
+	{
+		perror(name);
+		exit(1);
+	}
+	
+	std::vector<unsigned char> data;
+	int c, bad_frames=0;
+	while ((c = fgetc(file)) != EOF) data.push_back(c);
+	fclose(file);
+	
+	for (size_t i=0; i+4<data.size(); i++)
+	{
+		if (data[i] != 0x7E) continue;
+		
+		// Length, frame data, checksum
+		size_t length = (data[i+1] << 8) | data[i+2];
+		if ((length == 0) || (i + 4 + length > data.size())) continue;
+		
+		const unsigned char *frame = &data[i+3];
+		unsigned char checksum = 0;
+		for (size_t j=0; j<=length; j++) checksum += frame[j];
+		if (checksum != 0xFF)
+		{
+			bad_frames++;
+			continue;
+		}
+		i += 3 + length;
+		
+		// API ID, Source Address (2), RSSI, Options, then the telemetry packet
+		if ((frame[0] != XBEE_RX_16BIT) || (length < 8) || (frame[5] != TELEMETRY_SYSID)) continue;
+		
+		const unsigned char *packet = &frame[5];
+		unsigned int tick = (packet[1] << 8) | packet[2];
+		size_t count = (length - 8)/10;
+		
+		for (size_t j=0; j<count; j++)
+		{
+			const unsigned char *sample = &packet[3 + 10*j];
+			samples.push_back({tick + (unsigned int)j, read_int(&sample[0], 100), read_int(&sample[2], 100),
+				read_int(&sample[4], 100), read_int(&sample[6], 10), read_int(&sample[8], 10)});
+		}
+	}
+	
+	return bad_frames;
+}
+
+/**********************************
+Function name	:	solve
+Functionality	:	To solve a linear system by Gaussian elimination with partial pivoting
+Arguments		:	Matrix (row major, modified), Right hand side (replaced by the solution), Size
+Return Value	:	False if the system is singular
+Example Call	:	solve(A, b, 4)
+***********************************/
+bool solve(std::vector<double> &A, std::vector<double> &b, int n)
+{
+	for (int col=0; col<n; col++)
+	{
+		int pivot = col;
+		for (int row=col+1; row<n; row++)
+			if (fabs(A[row*n + col]) > fabs(A[pivot*n + col])) pivot = row;
+		if (fabs(A[pivot*n + col]) < 1e-12) return false;
+		
+		for (int k=0; k<n; k++) std::swap(A[col*n + k], A[pivot*n + k]);
+		std::swap(b[col], b[pivot]);
+		
+		for (int row=col+1; row<n; row++)
+		{
+			double factor = A[row*n + col]/A[col*n + col];
+			for (int k=col; k<n; k++) A[row*n + k] -= factor*A[col*n + k];
+			b[row] -= factor*b[col];
+		}
+	}
+	
+	for (int row=n-1; row>=0; row--)
+	{
+		for (int k=row+1; k<n; k++) b[row] -= A[row*n + k]*b[k];
+		b[row] /= A[row*n + row];
+	}
+	
+	return true;
+}
+
+/**********************************
+Function name	:	fit_arx
+Functionality	:	To fit y[k] = sum(a[i]*y[k-i]) + sum(b[i]*u[k-i]) by least squares,
+					regressors spanning lost frames are skipped
+Arguments		:	Ticks, Input, Output, Model order, Coefficients a[1..n] then b[1..n]
+Return Value	:	False if the fit failed
+Example Call	:	fit_arx(ticks, u, y, 2, theta)
+***********************************/
+bool fit_arx(const std::vector<unsigned int> &ticks, const std::vector<double> &u, const std::vector<double> &y,
+	int order, std::vector<double> &theta)
+{
+	int n = 2*order;
+	std::vector<double> A(n*n, 0), b(n, 0), phi(n);
+	int rows = 0;
+	
+	for (size_t k=order; k<y.size(); k++)
+	{
+		if ((ticks[k] - ticks[k-order]) != (unsigned int)order) continue;
+		
+		for (int i=1; i<=order; i++)
+		{
+			phi[i-1] = y[k-i];
+			phi[order+i-1] = u[k-i];
+		}
+		
+		// Normal equations
+		for (int r=0; r<n; r++)
+		{
+			for (int c=0; c<n; c++) A[r*n + c] += phi[r]*phi[c];
+			b[r] += phi[r]*y[k];
+		}
+		rows++;
+	}
+	
+	if (rows < n) return false;
+	theta = b;
+	return solve(A, theta, n);
+}
+
+/**********************************
+Function name	:	model_response
+Functionality	:	To evaluate the frequency response of the fitted model
+Arguments		:	Coefficients, Model order, Frequency (Hz)
+Return Value	:	Complex gain
+Example Call	:	model_response(theta, 2, 1.0)
+***********************************/
+Complex model_response(const std::vector<double> &theta, int order, double frequency)
+{
+	Complex z_inv = std::polar(1.0, -2*M_PI*frequency*SAMPLE_PERIOD);
+	Complex num = 0, den = 1, power = 1;
+	
+	for (int i=1; i<=order; i++)
+	{
+		power *= z_inv;
+		den -= theta[i-1]*power;
+		num += theta[order+i-1]*power;
+	}
+	
+	return num/den;
+}
+
+/**********************************
+Function name	:	data_response
+Functionality	:	To estimate the frequency response of the data from the DFT of input and output
+Arguments		:	Ticks, Input, Output, Frequency (Hz)
+Return Value	:	Complex gain
+Example Call	:	data_response(ticks, u, y, 1.0)
+***********************************/
+Complex data_response(const std::vector<unsigned int> &ticks, const std::vector<double> &u,
+	const std::vector<double> &y, double frequency)
+{
+	Complex U = 0, Y = 0;
+	
+	for (size_t k=0; k<u.size(); k++)
+	{
+		Complex w = std::polar(1.0, -2*M_PI*frequency*SAMPLE_PERIOD*(ticks[k] - ticks[0]));
+		U += u[k]*w;
+		Y += y[k]*w;
+	}
+	
+	return Y/U;
+}
+
+/**********************************
+Function name	:	print_model
+Functionality	:	To print the continuous time equivalent of the fitted model
+Arguments		:	Coefficients, Model order
+Return Value	:	None
+Example Call	:	print_model(theta, 1)
+***********************************/
+void print_model(const std::vector<double> &theta, int order)
+{
+	double a_sum = 0, b_sum = 0;
+	
+	printf("Discrete model:\n");
+	for (int i=1; i<=order; i++)
+	{
+		printf("  a%d = %+.6f   b%d = %+.6f\n", i, theta[i-1], i, theta[order+i-1]);
+		a_sum += theta[i-1];
+		b_sum += theta[order+i-1];
+	}
+	if (fabs(1 - a_sum) > 1e-9) printf("DC gain: %.4f\n", b_sum/(1 - a_sum));
+	
+	// First order: K/(tau*s + 1)
+	if ((order == 1) && (theta[0] > 0) && (theta[0] < 1))
+	{
+		double tau = -SAMPLE_PERIOD/log(theta[0]);
+		printf("Continuous model: K/(tau*s + 1), K = %.4f, tau = %.4f s\n", theta[1]/(1 - theta[0]), tau);
+	}
+	
+	// Second order: poles of z^2 - a1*z - a2 mapped with s = ln(z)/T
+	if (order == 2)
+	{
+		Complex root = std::sqrt(Complex(theta[0]*theta[0] + 4*theta[1], 0));
+		Complex poles[2] = {(theta[0] + root)/2.0, (theta[0] - root)/2.0};
+		
+		for (int i=0; i<2; i++)
+		{
+			Complex s = std::log(poles[i])/SAMPLE_PERIOD;
+			printf("Pole %d: z = %+.5f%+.5fj, s = %+.4f%+.4fj (wn = %.3f rad/s, zeta = %.3f)\n", i+1,
+				poles[i].real(), poles[i].imag(), s.real(), s.imag(), std::abs(s), -s.real()/std::abs(s));
+		}
+	}
+}
+
+/**********************************
+Function name	:	main
+Functionality	:	To decode the capture, fit the model and print the frequency response
+Arguments		:	Command line options
+Return Value	:	0 on success
+Example Call	:	./sysid_fit -y rpm -n 1 capture.bin
+***********************************/
+int main(int argc, char **argv)
+{
+	const char *input = "command", *output = "rpm", *csv = NULL, *capture = NULL;
+	int order = 1;
+	
+	for (int i=1; i<argc; i++)
+	{
+		if (!strcmp(argv[i], "-u") && (i+1 < argc)) input = argv[++i];
+		else if (!strcmp(argv[i], "-y") && (i+1 < argc)) output = argv[++i];
+		else if (!strcmp(argv[i], "-n") && (i+1 < argc)) order = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-c") && (i+1 < argc)) csv = argv[++i];
+		else capture = argv[i];
+	}
+	
+	if (!capture || (order < 1) || (order > MAX_ORDER))
+	{
+		fprintf(stderr, "usage: %s [-u excitation|command] [-y rpm|angle] [-n 1-%d] [-c log.csv] capture.bin\n",
+			argv[0], MAX_ORDER);
+		return 1;
+	}
+	
+	std::vector<Sample> samples;
+	int bad_frames = read_capture(capture, samples);
+	printf("Samples: %zu, bad frames: %d\n", samples.size(), bad_frames);
+	if (samples.empty()) return 1;
+	
+	// Optional CSV export for plotting
+	if (csv)
+	{
+		FILE *file = fopen(csv, "w");
+		if (!file)
+		{
+			perror(csv);
+			return 1;
+		}
+		fprintf(file, "tick,excitation,command,angle,left_RPM,right_RPM\n");
+		for (const Sample &s : samples)
+			fprintf(file, "%u,%.2f,%.2f,%.2f,%.1f,%.1f\n", s.tick, s.excitation, s.command, s.angle, s.left_RPM, s.right_RPM);
+		fclose(file);
+	}
+	
+	// Select the signals, means are removed so the fit is about the operating point
+	std::vector<unsigned int> ticks;
+	std::vector<double> u, y;
+	double u_mean = 0, y_mean = 0;
+	
+	for (const Sample &s : samples)
+	{
+		ticks.push_back(s.tick);
+		u.push_back(strcmp(input, "excitation") ? s.command : s.excitation);
+		y.push_back(strcmp(output, "angle") ? (s.left_RPM + s.right_RPM)/2 : s.angle);
+		u_mean += u.back();
+		y_mean += y.back();
+	}
+	
+	u_mean /= u.size();
+	y_mean /= y.size();
+	for (size_t k=0; k<u.size(); k++)
+	{
+		u[k] -= u_mean;
+		y[k] -= y_mean;
+	}
+	
+	std::vector<double> theta;
+	if (!fit_arx(ticks, u, y, order, theta))
+	{
+		fprintf(stderr, "sysid_fit: not enough excitation for an order %d fit\n", order);
+		return 1;
+	}
+	print_model(theta, order);
+	
+	// Bode table, log spaced up to the Nyquist frequency
+	printf("\n%10s %12s %12s %12s %12s\n", "f (Hz)", "data (dB)", "data (deg)", "model (dB)", "model (deg)");
+	for (double f=0.1; f<0.5/SAMPLE_PERIOD; f*=1.25)
+	{
+		Complex data = data_response(ticks, u, y, f);
+		Complex model = model_response(theta, order, f);
+		printf("%10.3f %12.2f %12.1f %12.2f %12.1f\n", f, 20*log10(std::abs(data)), std::arg(data)*180/M_PI,
+			20*log10(std::abs(model)), std::arg(model)*180/M_PI);
+	}
+	
+	return 0;
+}
\ No newline at end of file
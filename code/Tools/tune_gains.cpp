@@ -0,0 +1,365 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: tune_gains.cpp
+*
+* Created: 19-Oct-26 4:35:25 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Host optimiser for the angle, velocity and encoder PID gains. CMA-ES searches the
+* logarithm of the gains around the hand tuned values in pid_gains.h, every candidate
+* is scored on the same simulated scenarios, which run in parallel on all cores
+*
+* Build (from code/Tools):
+*   g++ -std=gnu++17 -O2 -DBARE_METAL -Ihost -o tune_gains tune_gains.cpp simulator.cpp batch_plant.cpp \
+*       $(find .. -name '*.cpp' -not -path '*Tools*' -not -name bare_metal.cpp -not -name Balance_Bot_2403.cpp)
+* Usage: ./tune_gains [-n scenarios] [-g generations] [-p population] [-s seed] [-j processes] > pid_gains.h
+*
+* Cost of a scenario: tilt RMS + drift and effort (COST_* weights), a fall costs COST_FALL
+* and the same again scaled by the time that was left. Candidates which fall in any of the
+* first RACE_SCENARIOS are not run on the rest. Zero gains (unused terms) and the slope mode
+* velocity gains are not changed. Progress and a check of the hand tuned and the optimised
+* gains on fresh scenarios go to stderr, copy the header over ../pid_gains.h if it is better.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "simulator.h"
+
+#define RACE_SCENARIOS		8			// Scenarios a candidate has to survive before the rest
+#define COST_TILT			1.0			// Per deg RMS
+#define COST_DRIFT			0.005		// Per mm
+#define COST_EFFORT			0.02		// Per PWM
+#define COST_FALL			20.0		// Per fall
+#define GAIN_RANGE			2.0			// Search limit either side of the hand tuned gains (ln)
+#define INITIAL_STEP		0.3			// Initial CMA-ES step size (ln)
+#define VALIDATION_SEED		1000000		// Seed offset of the scenarios for the final check
+
+typedef std::vector<double> Vector;
+typedef std::vector<Vector> Matrix;
+
+// Gains being tuned
+SimParams hand_tuned;
+int tuned[SIM_GAIN_COUNT];
+int dims = 0;
+
+/**********************************
+Function name	:	scenario_cost
+Functionality	:	To score the outcome of a scenario
+Arguments		:	Scenario parameters, Result
+Return Value	:	Cost
+Example Call	:	scenario_cost(&params, &result)
+***********************************/
+double scenario_cost(const SimParams *params, const SimResult *result)
+{
+	if (result->fallen) return COST_FALL*(2 - result->fall_time/params->duration);
+	return COST_TILT*result->tilt_RMS + COST_DRIFT*result->drift + COST_EFFORT*result->effort;
+}
+
+/**********************************
+Function name	:	candidate_gains
+Functionality	:	To set the gains of a candidate, the tuned gains are scaled by the
+					exponential of the search coordinates
+Arguments		:	Search coordinates, Gains
+Return Value	:	None
+Example Call	:	candidate_gains(x, params.gains)
+***********************************/
+void candidate_gains(const Vector &x, float *gains)
+{
+	for (int i=0; i<SIM_GAIN_COUNT; i++) gains[i] = hand_tuned.gains[i];
+	for (int k=0; k<dims; k++) gains[tuned[k]] *= exp(std::max(-GAIN_RANGE, std::min(GAIN_RANGE, x[k])));
+}
+
+/**********************************
+Function name	:	evaluate
+Functionality	:	To find the mean cost of candidates over the scenarios. When racing, candidates
+					which fall in the first RACE_SCENARIOS stop there and rank behind the rest
+Arguments		:	Candidates, Scenarios, Parallel processes, Race, Costs, Falls
+Return Value	:	None
+Example Call	:	evaluate(x, scenarios, 8, true, costs, falls)
+***********************************/
+void evaluate(const std::vector<Vector> &candidates, const std::vector<SimParams> &scenarios, int jobs, bool race,
+              Vector &costs, std::vector<int> &falls)
+{
+	int count = candidates.size(), total = scenarios.size();
+	int first = race ? std::min(RACE_SCENARIOS, total) : total;
+	std::vector<SimParams> params;
+	std::vector<SimResult> results;
+	std::vector<int> owner;
+	
+	costs.assign(count, 0);
+	falls.assign(count, 0);
+	
+	for (int stage=0; stage<2; stage++)
+	{
+		int from = stage ? first : 0, to = stage ? total : first;
+		
+		params.clear();
+		owner.clear();
+		for (int c=0; c<count; c++)
+		{
+			// Second stage only for the candidates which survived the first
+			if (stage && falls[c]) continue;
+			for (int s=from; s<to; s++)
+			{
+				params.push_back(scenarios[s]);
+				candidate_gains(candidates[c], params.back().gains);
+				owner.push_back(c);
+			}
+		}
+		if (params.empty()) continue;
+		
+		results.resize(params.size());
+		sim_batch(params.data(), results.data(), params.size(), jobs);
+		for (size_t i=0; i<params.size(); i++)
+		{
+			costs[owner[i]] += scenario_cost(&params[i], &results[i]);
+			falls[owner[i]] += results[i].fallen;
+		}
+	}
+	
+	for (int c=0; c<count; c++)
+	{
+		if (race && falls[c]) costs[c] = costs[c]/first + COST_FALL;
+		else costs[c] /= total;
+	}
+}
+
+/**********************************
+Function name	:	eigen
+Functionality	:	To diagonalise a symmetric matrix with Jacobi rotations
+Arguments		:	Matrix (destroyed), Eigenvectors (columns), Eigenvalues
+Return Value	:	None
+Example Call	:	eigen(C, B, D)
+***********************************/
+void eigen(Matrix A, Matrix &vectors, Vector &values)
+{
+	int n = A.size();
+	
+	vectors.assign(n, Vector(n, 0));
+	for (int i=0; i<n; i++) vectors[i][i] = 1;
+	
+	for (int sweep=0; sweep<50; sweep++)
+	{
+		double off = 0;
+		for (int p=0; p<n; p++) for (int q=p+1; q<n; q++) off += A[p][q]*A[p][q];
+		if (off < 1e-24) break;
+		
+		for (int p=0; p<n; p++) for (int q=p+1; q<n; q++)
+		{
+			if (fabs(A[p][q]) < 1e-30) continue;
+			
+			// Rotation which zeroes A[p][q]
+			double theta = (A[q][q] - A[p][p])/(2*A[p][q]);
+			double t = (theta >= 0 ? 1 : -1)/(fabs(theta) + sqrt(theta*theta + 1));
+			double c = 1/sqrt(t*t + 1), s = t*c;
+			
+			for (int k=0; k<n; k++)
+			{
+				double kp = A[k][p], kq = A[k][q];
+				A[k][p] = c*kp - s*kq;
+				A[k][q] = s*kp + c*kq;
+			}
+			for (int k=0; k<n; k++)
+			{
+				double pk = A[p][k], qk = A[q][k];
+				A[p][k] = c*pk - s*qk;
+				A[q][k] = s*pk + c*qk;
+			}
+			for (int k=0; k<n; k++)
+			{
+				double kp = vectors[k][p], kq = vectors[k][q];
+				vectors[k][p] = c*kp - s*kq;
+				vectors[k][q] = s*kp + c*kq;
+			}
+		}
+	}
+	
+	values.resize(n);
+	for (int i=0; i<n; i++) values[i] = A[i][i];
+}
+
+/**********************************
+Function name	:	print_header
+Functionality	:	To print pid_gains.h with the gains of a candidate
+Arguments		:	Search coordinates, Check costs and falls of the hand tuned and optimised gains, Scenarios
+Return Value	:	None
+Example Call	:	print_header(best, costs, falls, 48)
+***********************************/
+void print_header(const Vector &x, const Vector &costs, const std::vector<int> &falls, int count)
+{
+	const char *names[3] = {"ANGLE_GAINS\t\t", "VELOCITY_GAINS\t", "ENCODER_GAINS\t"};
+	float gains[SIM_GAIN_COUNT];
+	
+	candidate_gains(x, gains);
+	
+	printf("/*\n");
+	printf("* Project Name: Balance_Bot_2403\n");
+	printf("* File Name: pid_gains.h\n");
+	printf("*\n");
+	printf("* Gains of the angle, velocity and encoder PID controllers\n");
+	printf("* Order: conservative KP, KI, KD, aggressive KP, KI, KD\n");
+	printf("*\n");
+	printf("* Generated by Tools/tune_gains.cpp, cost %.3f with %d/%d falls in simulation\n", costs[1], falls[1], count);
+	printf("* (hand tuned gains %.3f with %d/%d falls)\n", costs[0], falls[0], count);
+	printf("*/\n\n");
+	printf("#ifndef PID_GAINS_H_\n#define PID_GAINS_H_\n\n");
+	
+	for (int pid=0; pid<3; pid++)
+	{
+		printf("#define %s", names[pid]);
+		for (int i=0; i<6; i++) printf(i ? ", %.4g" : "%.4g", gains[6*pid + i]);
+		printf("\n");
+	}
+	
+	printf("\n#endif");
+}
+
+int main(int argc, char **argv)
+{
+	int count = 24, generations = 40, population = 0, option = 0;
+	int jobs = std::thread::hardware_concurrency();
+	unsigned long seed = 2403;
+	
+	while ((option = getopt(argc, argv, "n:g:p:s:j:")) != -1)
+	{
+		switch (option)
+		{
+			case 'n': count = atoi(optarg); break;
+			case 'g': generations = atoi(optarg); break;
+			case 'p': population = atoi(optarg); break;
+			case 's': seed = strtoul(optarg, NULL, 0); break;
+			case 'j': jobs = atoi(optarg); break;
+			default:
+				fprintf(stderr, "Usage: %s [-n scenarios] [-g generations] [-p population] [-s seed] [-j processes] > pid_gains.h\n", argv[0]);
+				return 1;
+		}
+	}
+	if (count < 1) count = 1;
+	if (jobs < 1) jobs = 1;
+	
+	// Non-zero gains except the slope mode velocity gains
+	sim_defaults(&hand_tuned);
+	for (int i=0; i<SIM_GAIN_COUNT; i++)
+	{
+		if (hand_tuned.gains[i] == 0) continue;
+		if ((i >= SIM_VELOCITY_GAINS + 3) && (i < SIM_ENCODER_GAINS)) continue;
+		tuned[dims++] = i;
+	}
+	
+	std::vector<SimParams> scenarios(count), check(std::max(2*count, 32));
+	for (int i=0; i<count; i++) sim_random(&scenarios[i], seed + i);
+	for (size_t i=0; i<check.size(); i++) sim_random(&check[i], seed + VALIDATION_SEED + i);
+	
+	// CMA-ES settings
+	int n = dims, lambda = std::max(population, std::max(4 + (int)(3*log(n)), jobs)), mu = lambda/2;
+	Vector weights(mu);
+	double sum=0, mueff=0;
+	for (int i=0; i<mu; i++) sum += weights[i] = log(mu + 0.5) - log(i + 1);
+	for (int i=0; i<mu; i++) mueff += (weights[i] /= sum)*weights[i];
+	mueff = 1/mueff;
+	double cc = (4 + mueff/n)/(n + 4 + 2*mueff/n);
+	double cs = (mueff + 2)/(n + mueff + 5);
+	double c1 = 2/((n + 1.3)*(n + 1.3) + mueff);
+	double cmu = std::min(1 - c1, 2*(mueff - 2 + 1/mueff)/((n + 2)*(n + 2) + mueff));
+	double damps = 1 + 2*std::max(0.0, sqrt((mueff - 1)/(n + 1)) - 1) + cs;
+	double chiN = sqrt(n)*(1 - 1.0/(4*n) + 1.0/(21*n*n));
+	
+	// Search state, starting from the hand tuned gains
+	Vector mean(n, 0), pc(n, 0), ps(n, 0), D(n, 1), costs;
+	Matrix C(n, Vector(n, 0)), B;
+	double sigma = INITIAL_STEP;
+	std::mt19937 random(seed);
+	std::normal_distribution<double> normal(0, 1);
+	std::vector<int> falls;
+	for (int i=0; i<n; i++) C[i][i] = 1;
+	B = C;
+	
+	evaluate(std::vector<Vector>(1, mean), scenarios, jobs, true, costs, falls);
+	Vector best = mean;
+	double best_cost = costs[0];
+	fprintf(stderr, "%d gains, population %d, %d scenarios on %d processes\n", n, lambda, count, jobs);
+	fprintf(stderr, "hand tuned   cost %.4f\n", best_cost);
+	
+	for (int generation=0; generation<generations; generation++)
+	{
+		std::vector<Vector> y(lambda, Vector(n)), x(lambda, Vector(n));
+		std::vector<int> order(lambda);
+		int failed = 0;
+		
+		// Sample the population
+		for (int k=0; k<lambda; k++)
+		{
+			Vector z(n);
+			for (int i=0; i<n; i++) z[i] = D[i]*normal(random);
+			for (int i=0; i<n; i++)
+			{
+				y[k][i] = 0;
+				for (int j=0; j<n; j++) y[k][i] += B[i][j]*z[j];
+				x[k][i] = mean[i] + sigma*y[k][i];
+			}
+		}
+		
+		evaluate(x, scenarios, jobs, true, costs, falls);
+		for (int k=0; k<lambda; k++)
+		{
+			order[k] = k;
+			failed += (falls[k] > 0);
+		}
+		std::sort(order.begin(), order.end(), [&](int a, int b) {return costs[a] < costs[b];});
+		if (costs[order[0]] < best_cost)
+		{
+			best_cost = costs[order[0]];
+			best = x[order[0]];
+		}
+		
+		// Move the mean towards the best half
+		Vector y_w(n, 0), whitened(n, 0), rotated(n, 0);
+		for (int i=0; i<mu; i++) for (int j=0; j<n; j++) y_w[j] += weights[i]*y[order[i]][j];
+		for (int j=0; j<n; j++) mean[j] += sigma*y_w[j];
+		
+		// Evolution paths, C^-1/2 = B D^-1 B'
+		for (int i=0; i<n; i++) for (int j=0; j<n; j++) rotated[i] += B[j][i]*y_w[j];
+		for (int i=0; i<n; i++) for (int j=0; j<n; j++) whitened[i] += B[i][j]*rotated[j]/D[j];
+		double norm = 0;
+		for (int i=0; i<n; i++)
+		{
+			ps[i] = (1 - cs)*ps[i] + sqrt(cs*(2 - cs)*mueff)*whitened[i];
+			norm += ps[i]*ps[i];
+		}
+		norm = sqrt(norm);
+		bool hsig = norm/sqrt(1 - pow(1 - cs, 2*(generation + 1)))/chiN < 1.4 + 2.0/(n + 1);
+		for (int i=0; i<n; i++) pc[i] = (1 - cc)*pc[i] + hsig*sqrt(cc*(2 - cc)*mueff)*y_w[i];
+		
+		// Covariance and step size
+		for (int i=0; i<n; i++) for (int j=0; j<n; j++)
+		{
+			double rank_mu = 0;
+			for (int k=0; k<mu; k++) rank_mu += weights[k]*y[order[k]][i]*y[order[k]][j];
+			C[i][j] = (1 - c1 - cmu)*C[i][j] + c1*(pc[i]*pc[j] + (!hsig)*cc*(2 - cc)*C[i][j]) + cmu*rank_mu;
+		}
+		sigma *= exp((cs/damps)*(norm/chiN - 1));
+		eigen(C, B, D);
+		for (int i=0; i<n; i++) D[i] = sqrt(std::max(D[i], 1e-20));
+		
+		fprintf(stderr, "generation %3d  best %.4f  median %.4f  step %.3f  failed %d/%d\n",
+		        generation + 1, best_cost, costs[order[lambda/2]], sigma, failed, lambda);
+	}
+	
+	// Check on scenarios which were not used for the search
+	std::vector<Vector> final_pair = {Vector(n, 0), best};
+	evaluate(final_pair, check, jobs, false, costs, falls);
+	fprintf(stderr, "check on %d new scenarios: hand tuned %.4f (%d falls), optimised %.4f (%d falls)\n",
+	        (int)check.size(), costs[0], falls[0], costs[1], falls[1]);
+	
+	print_header(best, costs, falls, check.size());
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+/*
+* Project Name: Balance_Bot_2403
+* File Name: pid_gains.h
+*
+* Created: 19-Oct-26 4:35:25 PM
+* Author : agent
+*
+* Team: eYRC-BB#2403
+* Theme: Balance Bot
+*
+* Gains of the angle, velocity and encoder PID controllers
+* Order: conservative KP, KI, KD, aggressive KP, KI, KD
+*
+* The default gains were tuned by hand on the robot. Regenerate this file with
+* Tools/tune_gains.cpp to use gains optimised in the simulator.
+*/
+
+#ifndef PID_GAINS_H_
+#define PID_GAINS_H_
+
+#define ANGLE_GAINS		14, 3.2, 27, 20, 4, 32
+#define VELOCITY_GAINS	15, 0, 4, 5, 0, 0
+#define ENCODER_GAINS	1.5, 0, 0, 8.2, 0, 0
+
+#endif
\ No newline at end of file